@@ -1,6 +1,6 @@
 #include "battleLogic.h"
 
-int * totalFightsSimulated;
+thread_local int * totalFightsSimulated;
 
 // Prototype function! Currently not used. Function determining if a monster is strictly better than another
 bool isBetter(Monster * a, Monster * b, bool considerAbilities) {
@@ -11,14 +11,10 @@ bool isBetter(Monster * a, Monster * b, bool considerAbilities) {
     }
 }
 
-ArmyCondition leftCondition = ArmyCondition();
-ArmyCondition rightCondition = ArmyCondition();
-int turncounter;
-bool leftDied, rightDied;
-
 // TODO: Implement MAX AOE Damage to make sure nothing gets revived
-// Simulates One fight between 2 Armies and writes results into left's LastFightData
-void simulateFight(Army & left, Army & right, bool verbose) {
+// Simulates One fight between 2 loaded Armies and writes results into result
+// If resume is set the fight picks up where the fight in result ended, before the last monster of left was added
+static void resolveFight(ArmyCondition & leftCondition, ArmyCondition & rightCondition, FightResult & result, bool resume, bool verbose) {
     // left[0] and right[0] are the first monsters to fight
     // Damage Application Order: TODO: Find out exactly where wither ability triggers. probably after 6.
     //  1. Base Damage of creature
@@ -28,26 +24,30 @@ void simulateFight(Army & left, Army & right, bool verbose) {
     //  5. Protection of enemy Side     (protect, champion)
     //  6. AOE of friendly Side         (aoe, paoe)
     //  7. Healing of enemy Side        (healing)
+    int turncounter;
+    bool leftDied, rightDied;
+    
     (*totalFightsSimulated)++;
     
     turncounter = 0;
     
-    // Load Army data into conditions
-    leftCondition.init(left);
-    rightCondition.init(right);
-    
-    // Ignore lastFightData if either army-affecting heroes were added or for debugging
-    if (left.lastFightData.valid && !verbose) { 
+    if (resume) { 
         // Set pre-computed values to pick up where we left off
-        leftCondition.monstersLost      = left.monsterAmount-1; // All monsters of left died last fight only the new one counts
-        leftCondition.frontDamageTaken  = left.lastFightData.leftAoeDamage;
-        leftCondition.aoeDamageTaken    = left.lastFightData.leftAoeDamage;
-        rightCondition.monstersLost     = left.lastFightData.monstersLost;
-        rightCondition.frontDamageTaken = left.lastFightData.damage;
-        rightCondition.aoeDamageTaken   = left.lastFightData.rightAoeDamage;
-        rightCondition.berserkProcs     = left.lastFightData.berserk;
-        turncounter                     = left.lastFightData.turncounter;
+        leftCondition.monstersLost      = leftCondition.armySize-1; // All monsters of left died last fight only the new one counts
+        leftCondition.frontDamageTaken  = result.leftAoeDamage;
+        leftCondition.aoeDamageTaken    = result.leftAoeDamage;
+        rightCondition.monstersLost     = result.monstersLost;
+        rightCondition.frontDamageTaken = result.damage;
+        rightCondition.aoeDamageTaken   = result.rightAoeDamage;
+        rightCondition.berserkProcs     = result.berserk;
+        turncounter                     = result.turncounter;
+        COUNT(resumedFights);
+    } else {
+        COUNT(coldFights);
     }
+    #ifdef COSMOS_COUNTERS
+    int firstTurn = turncounter;
+    #endif
     
     // Battle Loop. Continues until one side is out of monsters
     while (true) {
@@ -56,8 +56,8 @@ void simulateFight(Army & left, Army & right, bool verbose) {
         }
         
         // Get damage with all relevant multipliers
-        leftCondition.getDamage(turncounter, rightCondition.lineup[rightCondition.monstersLost]->element);
-        rightCondition.getDamage(turncounter, leftCondition.lineup[leftCondition.monstersLost]->element);
+        leftCondition.getDamage(turncounter, rightCondition.element[rightCondition.monstersLost]);
+        rightCondition.getDamage(turncounter, leftCondition.element[leftCondition.monstersLost]);
         
         // Check if anything died as a result
         leftDied = leftCondition.resolveDamage(rightCondition.turnData);
@@ -69,7 +69,7 @@ void simulateFight(Army & left, Army & right, bool verbose) {
             leftCondition.frontDamageTaken += rightCondition.turnData.revengeDamage;
             
             // Only do this if left died as a result of added revenge damage of right
-            if (!leftDied && leftCondition.lineup[leftCondition.monstersLost]->hp <= leftCondition.frontDamageTaken) { 
+            if (!leftDied && leftCondition.hp[leftCondition.monstersLost] <= leftCondition.frontDamageTaken) { 
                 // Any additional damage can be handled next turn 
                 // TODO: Check if there can really be no faulty interactions if there are revenge monsters in the backline that die as a result
                 leftCondition.afterDeath();
@@ -81,10 +81,10 @@ void simulateFight(Army & left, Army & right, bool verbose) {
         
         // Handle wither ability
         if (!leftDied && leftCondition.skillTypes[leftCondition.monstersLost] == WITHER) {
-            leftCondition.frontDamageTaken += (int) ((float) (leftCondition.lineup[leftCondition.monstersLost]->hp - leftCondition.frontDamageTaken) * leftCondition.skillAmounts[leftCondition.monstersLost]);
+            leftCondition.frontDamageTaken += (int) ((float) (leftCondition.hp[leftCondition.monstersLost] - leftCondition.frontDamageTaken) * leftCondition.skillAmounts[leftCondition.monstersLost]);
         }
         if (!rightDied && rightCondition.skillTypes[rightCondition.monstersLost] == WITHER) {
-            rightCondition.frontDamageTaken += (int) ((float) (rightCondition.lineup[rightCondition.monstersLost]->hp - rightCondition.frontDamageTaken) * rightCondition.skillAmounts[rightCondition.monstersLost]);
+            rightCondition.frontDamageTaken += (int) ((float) (rightCondition.hp[rightCondition.monstersLost] - rightCondition.frontDamageTaken) * rightCondition.skillAmounts[rightCondition.monstersLost]);
         }
         
         // Output detailed fight Data for debugging
@@ -95,21 +95,78 @@ void simulateFight(Army & left, Army & right, bool verbose) {
         turncounter++;
     }
     
+    COUNT_ADD(turns, turncounter - firstTurn);
+    COUNT_MAX(maxTurns, turncounter - firstTurn);
+    
     // write all the results into a FightResult
-    left.lastFightData.dominated = false;
-    left.lastFightData.turncounter = (int8_t) turncounter;
-    left.lastFightData.leftAoeDamage = (int16_t) leftCondition.aoeDamageTaken;
-    left.lastFightData.rightAoeDamage = (int16_t) rightCondition.aoeDamageTaken;
+    result.dominated = false;
+    result.turncounter = (int8_t) turncounter;
+    result.leftAoeDamage = (int16_t) leftCondition.aoeDamageTaken;
+    result.rightAoeDamage = (int16_t) rightCondition.aoeDamageTaken;
     
     if (leftCondition.monstersLost >= leftCondition.armySize) { //draws count as right wins. 
-        left.lastFightData.rightWon = true;
-        left.lastFightData.monstersLost = (int8_t) rightCondition.monstersLost; 
-        left.lastFightData.damage = (int16_t) rightCondition.frontDamageTaken;
-        left.lastFightData.berserk = (int8_t) rightCondition.berserkProcs;
+        result.rightWon = true;
+        result.monstersLost = (int8_t) rightCondition.monstersLost; 
+        result.damage = (int16_t) rightCondition.frontDamageTaken;
+        result.berserk = (int8_t) rightCondition.berserkProcs;
     } else {
-        left.lastFightData.rightWon = false;
-        left.lastFightData.monstersLost = (int8_t) leftCondition.monstersLost; 
-        left.lastFightData.damage = (int16_t) leftCondition.frontDamageTaken;
-        left.lastFightData.berserk = (int8_t) leftCondition.berserkProcs;
+        result.rightWon = false;
+        result.monstersLost = (int8_t) leftCondition.monstersLost; 
+        result.damage = (int16_t) leftCondition.frontDamageTaken;
+        result.berserk = (int8_t) leftCondition.berserkProcs;
+    }
+}
+
+// Simulates One fight between 2 Armies and writes results into left's LastFightData
+void simulateFight(Army & left, Army & right, bool verbose) {
+    // Conditions are local so that several fights can run in parallel threads
+    ArmyCondition leftCondition = ArmyCondition();
+    ArmyCondition rightCondition = ArmyCondition();
+    
+    // Load Army data into conditions
+    leftCondition.init(left);
+    rightCondition.init(right);
+    
+    // Ignore lastFightData if either army-affecting heroes were added or for debugging
+    resolveFight(leftCondition, rightCondition, left.lastFightData, left.lastFightData.valid && !verbose, verbose);
+}
+
+// Simulates one fight between two armies that were loaded before. The conditions are copied, so they can be used again
+void simulateFight(const ArmyCondition & left, const ArmyCondition & right, FightResult & result) {
+    ArmyCondition leftCondition = left;
+    ArmyCondition rightCondition = right;
+    resolveFight(leftCondition, rightCondition, result, result.valid, false);
+}
+
+// Load the conditions of armies that are fought many times
+std::vector<ArmyCondition> loadConditions(const std::vector<Army> & armies) {
+    std::vector<ArmyCondition> conditions(armies.size(), ArmyCondition());
+    for (size_t i = 0; i < armies.size(); i++) {
+        conditions[i].init(armies[i]);
     }
-}
\ No newline at end of file
+    return conditions;
+}
+
+// Fights one army against many loaded targets, left is only loaded once
+void simulateFights(const Army & left, const std::vector<ArmyCondition> & targets, FightResult * results) {
+    ArmyCondition leftCondition = ArmyCondition();
+    leftCondition.init(left);
+    for (size_t i = 0; i < targets.size(); i++) {
+        simulateFight(leftCondition, targets[i], results[i]);
+    }
+}
+
+// Simulates one fight from the first turn with some heroes of left at other levels
+void simulateFight(Army & left, Army & right, const std::vector<LevelOverride> & overrides) {
+    ArmyCondition leftCondition = ArmyCondition();
+    ArmyCondition rightCondition = ArmyCondition();
+    
+    leftCondition.init(left);
+    rightCondition.init(right);
+    for (size_t i = 0; i < overrides.size(); i++) {
+        leftCondition.setLevel(overrides[i].slot, overrides[i].level, overrides[i].stats);
+    }
+    
+    // lastFightData belongs to the unchanged army, so it can't be resumed
+    resolveFight(leftCondition, rightCondition, left.lastFightData, false, false);
+}
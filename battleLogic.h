@@ -5,9 +5,10 @@
 #include <cmath>
 
 #include "cosmosClasses.h"
+#include "cosmosCounters.h"
 
 const float elementalBoost = 1.5; // Damage Boost if element has advantage over another
-extern int * totalFightsSimulated;
+extern thread_local int * totalFightsSimulated; // Counter of the solve running in the current thread
 
 const int VALID_RAINBOW_CONDITION = 15; // Binary 00001111 -> means all elements were added
 
@@ -26,7 +27,10 @@ struct TurnData {
 class ArmyCondition {
     public: 
         int armySize;
-        Monster * lineup[ARMY_MAX_SIZE];
+        int hp[ARMY_MAX_SIZE];
+        int damage[ARMY_MAX_SIZE];
+        int level[ARMY_MAX_SIZE];
+        Element element[ARMY_MAX_SIZE];
         SkillType skillTypes[ARMY_MAX_SIZE];
         Element skillTargets[ARMY_MAX_SIZE];
         float skillAmounts[ARMY_MAX_SIZE];
@@ -43,6 +47,8 @@ class ArmyCondition {
         TurnData turnData;
         
         inline void init(const Army & army);
+        inline void setMonster(int slot, const Monster & monster);
+        inline void setLevel(int slot, int level, const HeroStats & stats);
         inline void afterDeath();
         inline bool startNewTurn();
         inline void getDamage(const int turncounter, const Element opposingElement);
@@ -53,7 +59,6 @@ class ArmyCondition {
 // extract and extrapolate all necessary data from an army
 inline void ArmyCondition::init(const Army & army) {
     int i;
-    HeroSkill * skill;
     
     this->armySize = army.monsterAmount;
     this->monstersLost = 0;
@@ -63,23 +68,37 @@ inline void ArmyCondition::init(const Army & army) {
     this->berserkProcs = 0;
     
     for (i = 0; i < this->armySize; i++) {
-        this->lineup[i] = &monsterReference[army.monsters[i]];
-        this->rainbowCondition |= 1 << this->lineup[i]->element;
-        
-        skill = &(this->lineup[i]->skill);
-        this->skillTypes[i] = skill->type;
-        if (skill->type == RAINBOW) {
-            this->rainbowCondition = 0;
-        }
-        this->skillTargets[i] = skill->target;
-        this->skillAmounts[i] = skill->amount;
+        this->setMonster(i, monsterReference[army.monsters[i]]);
+    }
+}
+
+// Load the stats and skill of one monster into a slot, slots must be set front to back
+inline void ArmyCondition::setMonster(int slot, const Monster & monster) {
+    this->hp[slot] = monster.hp;
+    this->damage[slot] = monster.damage;
+    this->level[slot] = monster.level;
+    this->element[slot] = monster.element;
+    this->rainbowCondition |= 1 << monster.element;
+    
+    this->skillTypes[slot] = monster.skill.type;
+    if (monster.skill.type == RAINBOW) {
+        this->rainbowCondition = 0;
     }
+    this->skillTargets[slot] = monster.skill.target;
+    this->skillAmounts[slot] = monster.skill.amount;
+}
+
+// Let the hero in slot fight with the stats of another level
+inline void ArmyCondition::setLevel(int slot, int level, const HeroStats & stats) {
+    this->hp[slot] = stats.hp;
+    this->damage[slot] = stats.damage;
+    this->level[slot] = level;
 }
 
 // Handle death of the front-most monster
 inline void ArmyCondition::afterDeath() {
     if (this->skillTypes[this->monstersLost] == REVENGE) {
-        this->turnData.revengeDamage = (int16_t) round((float) this->lineup[this->monstersLost]->damage * this->skillAmounts[this->monstersLost]);
+        this->turnData.revengeDamage = (int16_t) round((float) this->damage[this->monstersLost] * this->skillAmounts[this->monstersLost]);
     }
     this->monstersLost++;
     this->berserkProcs = 0;
@@ -103,33 +122,43 @@ inline bool ArmyCondition::startNewTurn() {
     
     // Gather hero abilities' effects
     for (i = this->monstersLost; i < this->armySize; i++) {
-        if (this->aoeDamageTaken >= this->lineup[i]->hp) { // Check for Backline Deaths
+        if (this->aoeDamageTaken >= this->hp[i]) { // Check for Backline Deaths
             if (i == this->monstersLost) {
                 this->afterDeath();
             }
         } else {
             if (this->skillTypes[i] == NOTHING) {
+                COUNT(turnSkillHits[NOTHING]);
                 pureMonsters++; // count for friends ability
-            } else if (this->skillTypes[i] == PROTECT && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->lineup[this->monstersLost]->element)) {
+            } else if (this->skillTypes[i] == PROTECT && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->element[this->monstersLost])) {
+                COUNT(turnSkillHits[PROTECT]);
                 this->turnData.protection += (int) this->skillAmounts[i];
-            } else if (this->skillTypes[i] == BUFF && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->lineup[this->monstersLost]->element)) {
+            } else if (this->skillTypes[i] == BUFF && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->element[this->monstersLost])) {
+                COUNT(turnSkillHits[BUFF]);
                 this->turnData.buffDamage += (int) this->skillAmounts[i];
-            } else if (this->skillTypes[i] == CHAMPION && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->lineup[this->monstersLost]->element)) {
+            } else if (this->skillTypes[i] == CHAMPION && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->element[this->monstersLost])) {
+                COUNT(turnSkillHits[CHAMPION]);
                 this->turnData.buffDamage += (int) this->skillAmounts[i];
                 this->turnData.protection += (int) this->skillAmounts[i];
-            } else if (this->skillTypes[i] == PROTECT_L && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->lineup[this->monstersLost]->element)) {
-                this->turnData.protection += lineup[i]->level / (int) this->skillAmounts[i];
-            } else if (this->skillTypes[i] == BUFF_L && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->lineup[this->monstersLost]->element)) {
-                this->turnData.buffDamage += lineup[i]->level / (int) this->skillAmounts[i];
-            } else if (this->skillTypes[i] == CHAMPION_L && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->lineup[this->monstersLost]->element)) {
-                this->turnData.buffDamage += lineup[i]->level / (int) this->skillAmounts[i];
-                this->turnData.protection += lineup[i]->level / (int) this->skillAmounts[i];
+            } else if (this->skillTypes[i] == PROTECT_L && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->element[this->monstersLost])) {
+                COUNT(turnSkillHits[PROTECT_L]);
+                this->turnData.protection += this->level[i] / (int) this->skillAmounts[i];
+            } else if (this->skillTypes[i] == BUFF_L && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->element[this->monstersLost])) {
+                COUNT(turnSkillHits[BUFF_L]);
+                this->turnData.buffDamage += this->level[i] / (int) this->skillAmounts[i];
+            } else if (this->skillTypes[i] == CHAMPION_L && (this->skillTargets[i] == ALL || this->skillTargets[i] == this->element[this->monstersLost])) {
+                COUNT(turnSkillHits[CHAMPION_L]);
+                this->turnData.buffDamage += this->level[i] / (int) this->skillAmounts[i];
+                this->turnData.protection += this->level[i] / (int) this->skillAmounts[i];
             } else if (this->skillTypes[i] == HEAL) {
+                COUNT(turnSkillHits[HEAL]);
                 this->turnData.healing += (int) this->skillAmounts[i];
             } else if (this->skillTypes[i] == AOE) {
+                COUNT(turnSkillHits[AOE]);
                 this->turnData.aoeDamage += (int) this->skillAmounts[i];
             } else if (this->skillTypes[i] == P_AOE && i == this->monstersLost) {
-                this->turnData.paoeDamage += this->lineup[i]->damage;
+                COUNT(turnSkillHits[P_AOE]);
+                this->turnData.paoeDamage += this->damage[i];
             }
         }
     }
@@ -150,25 +179,30 @@ inline bool ArmyCondition::startNewTurn() {
 
 // Handle all self-centered abilites and other multipliers on damage
 inline void ArmyCondition::getDamage(const int turncounter, const Element opposingElement) {
-    this->turnData.baseDamage = (float) this->lineup[this->monstersLost]->damage; // Get Base damage
+    this->turnData.baseDamage = (float) this->damage[this->monstersLost]; // Get Base damage
     
     // Handle Monsters with skills berserk or friends or training etc.
     if (this->skillTypes[this->monstersLost] == FRIENDS) {
+        COUNT(damageSkillHits[FRIENDS]);
         this->turnData.baseDamage *= (float) pow(this->skillAmounts[this->monstersLost], this->pureMonsters);
     } else if (this->skillTypes[this->monstersLost] == TRAINING) {
+        COUNT(damageSkillHits[TRAINING]);
         this->turnData.baseDamage += this->skillAmounts[this->monstersLost] * (float) turncounter;
     } else if (this->skillTypes[this->monstersLost] == RAINBOW && this->rainbowCondition == VALID_RAINBOW_CONDITION) {
+        COUNT(damageSkillHits[RAINBOW]);
         this->turnData.baseDamage += this->skillAmounts[this->monstersLost];
     } else if (this->skillTypes[this->monstersLost] == ADAPT && opposingElement == this->skillTargets[this->monstersLost]) {
+        COUNT(damageSkillHits[ADAPT]);
         this->turnData.baseDamage *= this->skillAmounts[this->monstersLost];
     } else if (this->skillTypes[this->monstersLost] == BERSERK) {
+        COUNT(damageSkillHits[BERSERK]);
         this->turnData.baseDamage *= (float) pow(this->skillAmounts[this->monstersLost], this->berserkProcs);
         this->berserkProcs++;
     }
     
     this->turnData.baseDamage += (float) this->turnData.buffDamage; // Add Buff Damage
     
-    if (counter[opposingElement] == this->lineup[this->monstersLost]->element) {
+    if (counter[opposingElement] == this->element[this->monstersLost]) {
         this->turnData.baseDamage *= elementalBoost;
     }
 }
@@ -183,7 +217,7 @@ inline bool ArmyCondition::resolveDamage(TurnData & opposing) {
     opposing.revengeDamage = 0; // Vital to check for additional revenge damage later
     
     // Check if the first Monster died (otherwise it will be revived next turn)
-    if (this->lineup[this->monstersLost]->hp <= this->frontDamageTaken) {
+    if (this->hp[this->monstersLost] <= this->frontDamageTaken) {
         this->afterDeath();
         return true;
     } else {
@@ -194,7 +228,26 @@ inline bool ArmyCondition::resolveDamage(TurnData & opposing) {
 // Function determining if a monster is strictly better than another
 bool isBetter(Monster * a, Monster * b, bool considerAbilities = false);
 
+// A hero of the left army that fights at another level than the one in the army
+struct LevelOverride {
+    int slot;           // Position in the left army
+    int level;
+    HeroStats stats;    // Usually from leveledHeroStats in cosmosDefines
+};
+
 // Simulates One fight between 2 Armies
 void simulateFight(Army & left, Army & right, bool verbose = false);
 
+// Simulates one fight from the first turn with some heroes of left at other levels, the result is written into left.lastFightData
+// Used to scan hero levels without adding every leveled hero to monsterReference
+void simulateFight(Army & left, Army & right, const std::vector<LevelOverride> & overrides);
+
+// Batched fights for one army against many targets, e.g. tournament opponents. Every army is only loaded into an ArmyCondition once,
+// a fight starts from copies of the loaded conditions.
+// result is resumed from if it is valid, like lastFightData in the single fight
+void simulateFight(const ArmyCondition & left, const ArmyCondition & right, FightResult & result);
+std::vector<ArmyCondition> loadConditions(const std::vector<Army> & armies);
+// results[i] receives the fight against targets[i]
+void simulateFights(const Army & left, const std::vector<ArmyCondition> & targets, FightResult * results);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "cosmosAPI.h"
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+
+#include "cosmosDefines.h"
+#include "inputProcessing.h"
+#include "battleLogic.h"
+#include "solver.h"
+
+using namespace std;
+
+struct cq_handle {
+    SolverContext context;      // Roster and hooks used for solves
+    IOManager io;               // Silent, the library reports through return values and callbacks
+    vector<Army> armies;        // Armies created through this handle, referenced by their index
+    int minimumMonsterCost = 0;
+    int fightCounter = 0;       // Fights simulated outside of solves
+    set<MonsterIndex> leveledHeroes; // Leveled heroes this handle added, released when it is destroyed
+
+    string error;
+    string text;                // Backing storage for returned strings
+};
+
+static once_flag monsterDataInitialized;
+
+// Run an api call and turn exceptions into an error code with a message on the handle
+template <typename Function>
+static int guarded(cq_handle * handle, Function call) {
+    if (handle == NULL) {
+        return CQ_ERROR;
+    }
+    set<MonsterIndex> * previousOwner = leveledHeroOwner; // Callbacks may call into another handle
+    leveledHeroOwner = &handle->leveledHeroes;
+    try {
+        call();
+        leveledHeroOwner = previousOwner;
+        handle->error.clear();
+        return CQ_OK;
+    } catch (const exception & e) {
+        leveledHeroOwner = previousOwner;
+        handle->error = e.what();
+        return CQ_ERROR;
+    }
+}
+
+static Army & getArmy(cq_handle * handle, int army) {
+    if (army < 0 || army >= (int) handle->armies.size()) {
+        throw out_of_range("Unknown army id " + to_string(army));
+    }
+    return handle->armies[army];
+}
+
+extern "C" {
+
+cq_handle * cq_create(void) {
+    call_once(monsterDataInitialized, initMonsterData);
+    cq_handle * handle = new cq_handle();
+    handle->io.outputLevel = VITAL_OUTPUT;
+    handle->context.io = &handle->io;
+    handle->context.availableMonsters = filterMonsterData(handle->minimumMonsterCost);
+    return handle;
+}
+
+void cq_destroy(cq_handle * handle) {
+    if (handle != NULL) {
+        releaseLeveledHeroes(handle->leveledHeroes);
+    }
+    delete handle;
+}
+
+const char * cq_last_error(cq_handle * handle) {
+    return handle == NULL ? "Invalid handle" : handle->error.c_str();
+}
+
+int cq_add_hero(cq_handle * handle, const char * hero) {
+    return guarded(handle, [&]() {
+        pair<size_t, int> heroData = parseHeroString(toLower(hero));
+        handle->context.availableHeroes.push_back(addLeveledHero(heroData.first, heroData.second));
+    });
+}
+
+int cq_clear_heroes(cq_handle * handle) {
+    return guarded(handle, [&]() {
+        handle->context.availableHeroes.clear();
+    });
+}
+
+int cq_set_minimum_monster_cost(cq_handle * handle, int minimum_cost) {
+    return guarded(handle, [&]() {
+        handle->minimumMonsterCost = minimum_cost;
+        handle->context.availableMonsters = filterMonsterData(minimum_cost);
+    });
+}
+
+int cq_make_army(cq_handle * handle, const char * lineup, int * army) {
+    return guarded(handle, [&]() {
+        handle->armies.push_back(makeInstanceFromString(toLower(lineup)).target);
+        *army = (int) handle->armies.size() - 1;
+    });
+}
+
+int cq_army_followers(cq_handle * handle, int army, int * followers) {
+    return guarded(handle, [&]() {
+        *followers = getArmy(handle, army).followerCost;
+    });
+}
+
+const char * cq_army_string(cq_handle * handle, int army) {
+    int status = guarded(handle, [&]() {
+        handle->text = getArmy(handle, army).toString();
+    });
+    return status == CQ_OK ? handle->text.c_str() : NULL;
+}
+
+const char * cq_army_json(cq_handle * handle, int army) {
+    int status = guarded(handle, [&]() {
+        handle->text = getArmy(handle, army).toJSON();
+    });
+    return status == CQ_OK ? handle->text.c_str() : NULL;
+}
+
+int cq_clear_armies(cq_handle * handle) {
+    return guarded(handle, [&]() {
+        handle->armies.clear();
+    });
+}
+
+int cq_simulate_fights(cq_handle * handle, const int * left, const int * right, size_t count, cq_fight_result * results) {
+    return guarded(handle, [&]() {
+        Army leftArmy;
+        totalFightsSimulated = &handle->fightCounter;
+        for (size_t i = 0; i < count; i++) {
+            leftArmy = getArmy(handle, left[i]);
+            leftArmy.lastFightData.valid = false;
+            simulateFight(leftArmy, getArmy(handle, right[i]));
+
+            results[i].left_won = !leftArmy.lastFightData.rightWon;
+            results[i].monsters_lost = leftArmy.lastFightData.monstersLost;
+            results[i].damage = leftArmy.lastFightData.damage;
+            results[i].left_aoe_damage = leftArmy.lastFightData.leftAoeDamage;
+            results[i].right_aoe_damage = leftArmy.lastFightData.rightAoeDamage;
+            results[i].turns = leftArmy.lastFightData.turncounter;
+        }
+    });
+}
+
+int cq_solve(cq_handle * handle, const char * target, int max_followers,
+             cq_progress_callback progress, cq_solution_callback solution, void * user_data, cq_solution * result) {
+    return guarded(handle, [&]() {
+        Instance instance = makeInstanceFromString(toLower(target));
+        instance.followerUpperBound = max_followers < 0 ? numeric_limits<int>::max() : max_followers;
+
+        handle->context.onProgress = nullptr;
+        handle->context.onNewSolution = nullptr;
+        if (progress != NULL) {
+            handle->context.onProgress = [&](const Instance & current, size_t armySize, size_t pureArmies, size_t heroArmies) {
+                return progress(user_data, (int) armySize, (int) current.maxCombatants, pureArmies, heroArmies) != 0;
+            };
+        }
+        if (solution != NULL) {
+            handle->context.onNewSolution = [&](const Instance & current) {
+                Army best = current.bestSolution;
+                solution(user_data, best.followerCost, best.toString().c_str());
+            };
+        }
+
+        solveInstance(instance, handle->context);
+        handle->context.onProgress = nullptr;
+        handle->context.onNewSolution = nullptr;
+
+        handle->armies.push_back(instance.bestSolution);
+        result->found = !instance.bestSolution.isEmpty();
+        result->followers = instance.bestSolution.followerCost;
+        result->army = (int) handle->armies.size() - 1;
+        result->fights = instance.totalFightsSimulated;
+        result->seconds = (long long) instance.calculationTime;
+    });
+}
+
+}
@@ -0,0 +1,73 @@
+#ifndef COSMOS_API_HEADER
+#define COSMOS_API_HEADER
+
+/*
+ * C interface of libcosmosquest for running fights and solves in-process.
+ * All state lives in a cq_handle. Handles may be used from different threads at the same time,
+ * a single handle must only be used by one thread at a time.
+ * Functions returning int return CQ_OK on success, error details are available via cq_last_error.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define CQ_OK 0
+#define CQ_ERROR -1
+
+typedef struct cq_handle cq_handle;
+
+/* Condition of the winning side after a fight, mirrors FightResult */
+typedef struct {
+    int left_won;           /* 1 if the left army won, draws count as right wins */
+    int monsters_lost;      /* Monsters the winning side lost */
+    int damage;             /* Damage dealt to the leading monster of the winning side */
+    int left_aoe_damage;    /* Aoe damage the left side took */
+    int right_aoe_damage;   /* Aoe damage the right side took */
+    int turns;              /* Turns until the fight ended */
+} cq_fight_result;
+
+/* Summary of a finished solve. The lineup stays valid until the next call on the handle */
+typedef struct {
+    int found;              /* 1 if a winning lineup was found */
+    int followers;          /* Follower cost of the solution */
+    int army;               /* Army id of the solution, usable with all army functions */
+    long long fights;       /* Fights simulated during the solve */
+    long long seconds;      /* Calculation time */
+} cq_solution;
+
+/* Called at the start of every army size. Return 0 to stop the solve and keep the best solution so far */
+typedef int (*cq_progress_callback)(void * user_data, int army_size, int max_army_size, size_t pure_armies, size_t hero_armies);
+/* Called whenever a cheaper winning lineup is found. lineup is only valid during the call */
+typedef void (*cq_solution_callback)(void * user_data, int followers, const char * lineup);
+
+cq_handle * cq_create(void);
+void cq_destroy(cq_handle * handle);
+const char * cq_last_error(cq_handle * handle);
+
+/* Roster setup. Heroes are given as name:level, monsters cheaper than minimum_cost are not used in solves */
+int cq_add_hero(cq_handle * handle, const char * hero);
+int cq_clear_heroes(cq_handle * handle);
+int cq_set_minimum_monster_cost(cq_handle * handle, int minimum_cost);
+
+/* Armies are built from lineup strings like "a1,geror:22,f13" or quest strings like "quest23-3" and referenced by id */
+int cq_make_army(cq_handle * handle, const char * lineup, int * army);
+int cq_army_followers(cq_handle * handle, int army, int * followers);
+const char * cq_army_string(cq_handle * handle, int army);
+const char * cq_army_json(cq_handle * handle, int army);
+int cq_clear_armies(cq_handle * handle);
+
+/* Fight count pairs of armies. left[i] fights right[i] and the outcome is written to results[i] */
+int cq_simulate_fights(cq_handle * handle, const int * left, const int * right, size_t count, cq_fight_result * results);
+
+/* Find the cheapest lineup beating target. max_followers < 0 means no limit. Callbacks may be NULL */
+int cq_solve(cq_handle * handle, const char * target, int max_followers,
+             cq_progress_callback progress, cq_solution_callback solution, void * user_data, cq_solution * result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
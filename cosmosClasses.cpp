@@ -21,14 +21,23 @@ Monster::Monster(int someHp, int someDamage, int aCost, std::string aName, Eleme
     name(aName)
 {
     if (this->rarity != NO_HERO) {
-        int points = this->rarity * (this->level-1);
-        int value = this->hp + this->damage;
+        HeroStats stats = levelHeroStats(this->hp, this->damage, this->rarity, this->level);
         this->name = this->baseName + HEROLEVEL_SEPARATOR() + std::to_string(this->level);
-        this->hp = this->hp + (int) round((float) points * (float) this->hp / (float) value);
-        this->damage = this->damage + (int) round((float) points * (float) this->damage / (float) value);
+        this->hp = stats.hp;
+        this->damage = stats.damage;
     }
 }
 
+// Distribute the stat points a hero gains by leveling over its base hp and damage
+HeroStats levelHeroStats(int baseHp, int baseDamage, HeroRarity rarity, int level) {
+    int points = rarity * (level-1);
+    int value = baseHp + baseDamage;
+    HeroStats stats;
+    stats.hp = baseHp + (int) round((float) points * (float) baseHp / (float) value);
+    stats.damage = baseDamage + (int) round((float) points * (float) baseDamage / (float) value);
+    return stats;
+}
+
 // Contructor for normal Monsters
 Monster::Monster(int someHp, int someDamage, int aCost, std::string aName, Element anElement) : 
     Monster(someHp, someDamage, aCost, aName, anElement, NO_HERO, NO_SKILL, 0) {}
@@ -60,7 +69,7 @@ bool isCheaper(const Monster & a, const Monster & b) {
     return a.cost < b.cost;
 }
 
-bool Army::isEmpty() {
+bool Army::isEmpty() const {
     return (this->monsterAmount == 0);
 }
 
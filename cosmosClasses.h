@@ -8,6 +8,20 @@
 #include <cstdint>
 #include <sstream>
 #include <cmath>
+#include <limits>
+
+// Monsters are referenced by their index in monsterReference. The width of that index is a compile time parameter:
+// 8 bits keep armies compact and are the default, 16 bits allow large rosters (make INDEX_BITS=16)
+#ifndef COSMOS_INDEX_BITS
+#define COSMOS_INDEX_BITS 8
+#endif
+template <int bits> struct MonsterIndexType;
+template <> struct MonsterIndexType<8> { typedef int8_t type; };
+template <> struct MonsterIndexType<16> { typedef int16_t type; };
+typedef MonsterIndexType<COSMOS_INDEX_BITS>::type MonsterIndex;
+
+const size_t MONSTER_INDEX_BITS = COSMOS_INDEX_BITS;
+const size_t MONSTER_REFERENCE_CAPACITY = (size_t) std::numeric_limits<MonsterIndex>::max() + 1; // Indices must stay positive
 
 const size_t ARMY_MAX_SIZE = 6;
 const size_t TOURNAMENT_LINES = 5;
@@ -35,6 +49,11 @@ enum SkillType {
     WITHER,     // This monster's hp decrease after every attack it survives
     REVENGE     // After this onster dies it damages the entire opposing army
 };
+const size_t SKILL_TYPE_AMOUNT = REVENGE + 1;
+const std::string SKILL_TYPE_NAMES[SKILL_TYPE_AMOUNT] {
+    "nothing", "buff", "buff_l", "protect", "protect_l", "aoe", "p_aoe", "heal", "berserk",
+    "friends", "champion", "champion_l", "adapt", "rainbow", "training", "wither", "revenge"
+};
 
 enum Element {
     EARTH   = 0,
@@ -45,6 +64,8 @@ enum Element {
     SELF         // These Values are used to specify targets of hero skills
 };
 const Element counter [] { FIRE, EARTH, AIR, WATER, SELF, SELF }; // Elemental Advantages earth = 0 -> counter[0] = fire -> fire has advantage over earth
+const size_t ELEMENT_AMOUNT = SELF + 1;
+const std::string ELEMENT_NAMES[ELEMENT_AMOUNT] {"earth", "air", "water", "fire", "all", "self"};
 
 // Defines Skills of Heros
 struct HeroSkill {
@@ -62,6 +83,15 @@ enum HeroRarity {
     LEGENDARY = 6 // Values define how many stat points per level a hero of this rarity gets
 };
 
+// Hitpoints and damage of a hero at some level
+struct HeroStats {
+    int hp;
+    int damage;
+};
+
+// Distribute the stat points a hero gains by leveling over its base hp and damage
+HeroStats levelHeroStats(int baseHp, int baseDamage, HeroRarity rarity, int level);
+
 // Defines a Monster or Hero
 class Monster {
     private:
@@ -125,10 +155,10 @@ class Army {
     public:
         FightResult lastFightData;
         int32_t followerCost;
-        int8_t monsters[ARMY_MAX_SIZE];
+        MonsterIndex monsters[ARMY_MAX_SIZE];
         int8_t monsterAmount;
         
-        Army(std::vector<int8_t> someMonsters = {}) :
+        Army(std::vector<MonsterIndex> someMonsters = {}) :
             followerCost(0),
             monsterAmount(0)
         {
@@ -138,13 +168,13 @@ class Army {
         }
         
         // Add monster to the back of the army
-        void add(const int8_t m) {
+        void add(const MonsterIndex m) {
             this->monsters[monsterAmount] = m;
             this->followerCost += monsterReference[m].cost;
             this->monsterAmount++;
         }
         
-        bool isEmpty();
+        bool isEmpty() const;
         std::string toString();
         std::string toJSON();
 };
@@ -0,0 +1,67 @@
+#include "cosmosCounters.h"
+
+#include <sstream>
+#include <mutex>
+#include <algorithm>
+
+thread_local EngineCounters threadCounters;
+
+static std::mutex collectMutex;
+
+void EngineCounters::merge(const EngineCounters & other) {
+    this->resumedFights += other.resumedFights;
+    this->coldFights += other.coldFights;
+    this->turns += other.turns;
+    this->maxTurns = std::max(this->maxTurns, other.maxTurns);
+    for (size_t i = 0; i < SKILL_TYPE_AMOUNT; i++) {
+        this->turnSkillHits[i] += other.turnSkillHits[i];
+        this->damageSkillHits[i] += other.damageSkillHits[i];
+    }
+    this->prunedOptimizable += other.prunedOptimizable;
+    this->prunedPureDominance += other.prunedPureDominance;
+    this->prunedHeroDominance += other.prunedHeroDominance;
+    this->prunedPureOverHero += other.prunedPureOverHero;
+    this->expandedParents += other.expandedParents;
+    this->expandedChildren += other.expandedChildren;
+    this->maxChildren = std::max(this->maxChildren, other.maxChildren);
+}
+
+// Add the counters of the current thread to target and reset them
+void collectThreadCounters(EngineCounters & target) {
+    std::lock_guard<std::mutex> lock(collectMutex);
+    target.merge(threadCounters);
+    threadCounters = EngineCounters();
+}
+
+// Print skill hits as an object, leaving out skills that never triggered
+static void skillHitsToJSON(std::stringstream & s, const uint64_t hits[SKILL_TYPE_AMOUNT]) {
+    bool first = true;
+    s << "{";
+    for (size_t i = 0; i < SKILL_TYPE_AMOUNT; i++) {
+        if (hits[i] > 0) {
+            s << (first ? "" : ",") << "\"" << SKILL_TYPE_NAMES[i] << "\"" << ":" << hits[i];
+            first = false;
+        }
+    }
+    s << "}";
+}
+
+std::string EngineCounters::toJSON() const {
+    std::stringstream s;
+    s << "{";
+        s << "\"resumedFights\"" << ":" << this->resumedFights << ",";
+        s << "\"coldFights\"" << ":" << this->coldFights << ",";
+        s << "\"turns\"" << ":" << this->turns << ",";
+        s << "\"maxTurns\"" << ":" << this->maxTurns << ",";
+        s << "\"turnSkillHits\"" << ":"; skillHitsToJSON(s, this->turnSkillHits); s << ",";
+        s << "\"damageSkillHits\"" << ":"; skillHitsToJSON(s, this->damageSkillHits); s << ",";
+        s << "\"prunedOptimizable\"" << ":" << this->prunedOptimizable << ",";
+        s << "\"prunedPureDominance\"" << ":" << this->prunedPureDominance << ",";
+        s << "\"prunedHeroDominance\"" << ":" << this->prunedHeroDominance << ",";
+        s << "\"prunedPureOverHero\"" << ":" << this->prunedPureOverHero << ",";
+        s << "\"expandedParents\"" << ":" << this->expandedParents << ",";
+        s << "\"expandedChildren\"" << ":" << this->expandedChildren << ",";
+        s << "\"maxChildren\"" << ":" << this->maxChildren;
+    s << "}";
+    return s.str();
+}
@@ -0,0 +1,58 @@
+#ifndef COSMOS_COUNTERS_HEADER
+#define COSMOS_COUNTERS_HEADER
+
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+#include "cosmosClasses.h"
+
+// Counters are only gathered if compiled with COSMOS_COUNTERS (make COUNTERS=1). Otherwise COUNT compiles to nothing
+#ifdef COSMOS_COUNTERS
+    #define COUNT(counter) (threadCounters.counter++)
+    #define COUNT_ADD(counter, amount) (threadCounters.counter += (uint64_t) (amount))
+    #define COUNT_MAX(counter, value) (threadCounters.counter = std::max(threadCounters.counter, (uint64_t) (value)))
+#else
+    #define COUNT(counter) ((void) 0)
+    #define COUNT_ADD(counter, amount) ((void) 0)
+    #define COUNT_MAX(counter, value) ((void) 0)
+#endif
+
+// Statistics about the fight engine and the pruning of the solver
+struct EngineCounters {
+    uint64_t resumedFights = 0;     // Fights that continued from lastFightData
+    uint64_t coldFights = 0;        // Fights simulated from the first turn
+    uint64_t turns = 0;             // Turns simulated over all fights
+    uint64_t maxTurns = 0;          // Most turns simulated in a single fight
+    uint64_t turnSkillHits[SKILL_TYPE_AMOUNT] = {};     // Skill branches taken in startNewTurn
+    uint64_t damageSkillHits[SKILL_TYPE_AMOUNT] = {};   // Skill branches taken in getDamage
+
+    uint64_t prunedOptimizable = 0;     // Armies that cannot beat the last two enemies with one more monster
+    uint64_t prunedPureDominance = 0;   // Pure armies dominated by a cheaper pure army
+    uint64_t prunedHeroDominance = 0;   // Hero armies dominated by a cheaper army using a subset of the heroes
+    uint64_t prunedPureOverHero = 0;    // Hero armies dominated by a cheaper pure army
+
+    uint64_t expandedParents = 0;   // Armies that were expanded
+    uint64_t expandedChildren = 0;  // Armies created by expanding
+    uint64_t maxChildren = 0;       // Most children created from a single parent
+
+    void merge(const EngineCounters & other);
+    std::string toJSON() const;
+};
+
+// Counters of the current thread. Threads gather separately and merge their counters once they finish
+extern thread_local EngineCounters threadCounters;
+
+// Record the amount of children a single army produced when expanding
+inline void countExpansion(size_t children) {
+#ifdef COSMOS_COUNTERS
+    threadCounters.expandedParents++;
+    threadCounters.expandedChildren += children;
+    threadCounters.maxChildren = std::max(threadCounters.maxChildren, (uint64_t) children);
+#endif
+}
+
+// Add the counters of the current thread to target and reset them. Safe to call from several threads
+void collectThreadCounters(EngineCounters & target);
+
+#endif
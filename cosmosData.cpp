@@ -0,0 +1,414 @@
+#include "cosmosData.h"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <cstring>
+#include <cstdio>
+#include <stdexcept>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+#include "cosmosDefines.h"
+#include "inputProcessing.h"
+
+using namespace std;
+
+// Layout of the binary cache. Change the magic whenever the layout changes so old caches get rebuilt
+static const char DATA_CACHE_MAGIC[8] = "CQDATA1";
+static const size_t DATA_NAME_LENGTH = 24;
+
+struct DataCacheHeader {
+    char magic[8];
+    uint32_t versions[3];       // Versions of the monster, hero and quest files
+    uint32_t monsterCount;
+    uint32_t heroCount;
+    uint32_t questCount;
+    uint32_t questMonsterCount;
+};
+
+struct MonsterRecord {
+    int32_t hp;
+    int32_t damage;
+    int32_t cost;
+    int32_t element;
+    char name[DATA_NAME_LENGTH];
+};
+
+struct HeroRecord {
+    int32_t hp;
+    int32_t damage;
+    int32_t element;
+    int32_t rarity;
+    int32_t skillType;
+    int32_t skillTarget;
+    int32_t skillSource;
+    float skillAmount;
+    char name[DATA_NAME_LENGTH];
+};
+// Followed by questCount + 1 uint32_t offsets into questMonsterCount int8_t monster numbers
+
+static const HeroRarity RARITIES[] {COMMON, RARE, LEGENDARY};
+static const string RARITY_NAMES[] {"common", "rare", "legendary"};
+
+static string joinPath(const string & directory, const string & file) {
+    return directory.empty() ? file : directory + "/" + file;
+}
+
+// Modification time of a file, -1 if it does not exist
+static time_t modificationTime(const string & path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return -1;
+    }
+    return info.st_mtime;
+}
+
+// Find name in a list of names and return its position
+static int findName(const string & name, const string names[], size_t amount, const string & path) {
+    for (size_t i = 0; i < amount; i++) {
+        if (names[i] == name) {
+            return (int) i;
+        }
+    }
+    throw runtime_error(path + ": Unknown value " + name);
+}
+
+static void copyName(char target[DATA_NAME_LENGTH], const string & name, const string & path) {
+    if (name.empty() || name.length() >= DATA_NAME_LENGTH) {
+        throw runtime_error(path + ": Invalid name " + name);
+    }
+    memset(target, 0, DATA_NAME_LENGTH);
+    memcpy(target, name.c_str(), name.length());
+}
+
+// Read the rows of a data file split at whitespace. Empty lines and everything after // are ignored
+static uint32_t readDataFile(const string & path, vector<vector<string>> & rows) {
+    ifstream file(path);
+    if (!file.is_open()) {
+        throw runtime_error("Could not open " + path);
+    }
+    string line, token;
+    int64_t version = -1;
+    while (getline(file, line)) {
+        line = line.substr(0, line.find(COMMENT_DELIMITOR));
+        istringstream tokens(line);
+        vector<string> row;
+        while (tokens >> token) {
+            row.push_back(token);
+        }
+        if (row.empty()) {
+            continue;
+        }
+        if (version < 0) {
+            if (row.size() != 2 || row[0] != "version") {
+                throw runtime_error(path + ": Data files must start with a version line");
+            }
+            version = stoll(row[1]);
+        } else {
+            rows.push_back(row);
+        }
+    }
+    if (version < 0) {
+        throw runtime_error(path + ": Data files must start with a version line");
+    }
+    return (uint32_t) version;
+}
+
+template <typename T> static void appendBytes(vector<char> & bytes, const T & value) {
+    bytes.insert(bytes.end(), (const char *) &value, (const char *) &value + sizeof(T));
+}
+
+// Parse the text files of directory into the layout of the binary cache
+static vector<char> compileGameData(const string & directory) {
+    DataCacheHeader header;
+    vector<vector<string>> monsterRows, heroRows, questRows;
+    string monsterPath = joinPath(directory, MONSTER_DATA_FILE);
+    string heroPath = joinPath(directory, HERO_DATA_FILE);
+    string questPath = joinPath(directory, QUEST_DATA_FILE);
+
+    memcpy(header.magic, DATA_CACHE_MAGIC, sizeof(header.magic));
+    header.versions[0] = readDataFile(monsterPath, monsterRows);
+    header.versions[1] = readDataFile(heroPath, heroRows);
+    header.versions[2] = readDataFile(questPath, questRows);
+
+    vector<MonsterRecord> monsters;
+    vector<string> monsterNames;
+    for (size_t i = 0; i < monsterRows.size(); i++) {
+        vector<string> & row = monsterRows[i];
+        if (row.size() != 5) {
+            throw runtime_error(monsterPath + ": Expected name hp damage cost element");
+        }
+        MonsterRecord record;
+        copyName(record.name, row[0], monsterPath);
+        record.hp = stoi(row[1]);
+        record.damage = stoi(row[2]);
+        record.cost = stoi(row[3]);
+        record.element = findName(row[4], ELEMENT_NAMES, FIRE + 1, monsterPath);
+        monsters.push_back(record);
+        monsterNames.push_back(row[0]);
+    }
+    if (monsters.size() > (size_t) numeric_limits<int8_t>::max()) {
+        throw runtime_error(monsterPath + ": Too many monsters");
+    }
+
+    vector<HeroRecord> heroes;
+    for (size_t i = 0; i < heroRows.size(); i++) {
+        vector<string> & row = heroRows[i];
+        if (row.size() != 9) {
+            throw runtime_error(heroPath + ": Expected name hp damage element rarity skill target sourceElement amount");
+        }
+        HeroRecord record;
+        copyName(record.name, row[0], heroPath);
+        record.hp = stoi(row[1]);
+        record.damage = stoi(row[2]);
+        record.element = findName(row[3], ELEMENT_NAMES, FIRE + 1, heroPath);
+        record.rarity = RARITIES[findName(row[4], RARITY_NAMES, 3, heroPath)];
+        record.skillType = findName(row[5], SKILL_TYPE_NAMES, SKILL_TYPE_AMOUNT, heroPath);
+        record.skillTarget = findName(row[6], ELEMENT_NAMES, ELEMENT_AMOUNT, heroPath);
+        record.skillSource = findName(row[7], ELEMENT_NAMES, ELEMENT_AMOUNT, heroPath);
+        record.skillAmount = stof(row[8]);
+        heroes.push_back(record);
+    }
+
+    // Quests are stored as monster numbers so loading them needs no name lookups
+    vector<vector<int8_t>> questNumbers;
+    for (size_t i = 0; i < questRows.size(); i++) {
+        vector<string> & row = questRows[i];
+        size_t questNumber = stoul(row[0]);
+        if (row.size() < 2 || row.size() > ARMY_MAX_SIZE + 1) {
+            throw runtime_error(questPath + ": Expected quest number and up to " + to_string(ARMY_MAX_SIZE) + " monsters");
+        }
+        if (questNumbers.size() <= questNumber) {
+            questNumbers.resize(questNumber + 1);
+        }
+        questNumbers[questNumber].clear();
+        for (size_t j = 1; j < row.size(); j++) {
+            questNumbers[questNumber].push_back((int8_t) findName(row[j], monsterNames.data(), monsterNames.size(), questPath));
+        }
+    }
+
+    header.monsterCount = (uint32_t) monsters.size();
+    header.heroCount = (uint32_t) heroes.size();
+    header.questCount = (uint32_t) questNumbers.size();
+    header.questMonsterCount = 0;
+    for (size_t i = 0; i < questNumbers.size(); i++) {
+        header.questMonsterCount += (uint32_t) questNumbers[i].size();
+    }
+
+    vector<char> bytes;
+    appendBytes(bytes, header);
+    for (size_t i = 0; i < monsters.size(); i++) {
+        appendBytes(bytes, monsters[i]);
+    }
+    for (size_t i = 0; i < heroes.size(); i++) {
+        appendBytes(bytes, heroes[i]);
+    }
+    uint32_t offset = 0;
+    for (size_t i = 0; i <= questNumbers.size(); i++) {
+        appendBytes(bytes, offset);
+        if (i < questNumbers.size()) {
+            offset += (uint32_t) questNumbers[i].size();
+        }
+    }
+    for (size_t i = 0; i < questNumbers.size(); i++) {
+        bytes.insert(bytes.end(), questNumbers[i].begin(), questNumbers[i].end());
+    }
+    return bytes;
+}
+
+// Replace the game data with the content of a binary cache
+static void useGameData(const char * data, size_t size, const string & path) {
+    DataCacheHeader header;
+    if (size < sizeof(header)) {
+        throw runtime_error(path + ": Cache is too small");
+    }
+    memcpy(&header, data, sizeof(header));
+    size_t questOffset = sizeof(header) + header.monsterCount * sizeof(MonsterRecord) + header.heroCount * sizeof(HeroRecord);
+    size_t expectedSize = questOffset + (header.questCount + 1) * sizeof(uint32_t) + header.questMonsterCount;
+    if (memcmp(header.magic, DATA_CACHE_MAGIC, sizeof(header.magic)) != 0 || size != expectedSize) {
+        throw runtime_error(path + ": Cache is damaged, delete it to rebuild it");
+    }
+
+    const MonsterRecord * monsters = (const MonsterRecord *) (data + sizeof(header));
+    const HeroRecord * heroes = (const HeroRecord *) (monsters + header.monsterCount);
+    const uint32_t * questOffsets = (const uint32_t *) (data + questOffset);
+    const int8_t * questMonsters = (const int8_t *) (questOffsets + header.questCount + 1);
+
+    monsterBaseList.clear();
+    for (size_t i = 0; i < header.monsterCount; i++) {
+        monsterBaseList.push_back(Monster(monsters[i].hp, monsters[i].damage, monsters[i].cost, monsters[i].name, (Element) monsters[i].element));
+    }
+    baseHeroes.clear();
+    for (size_t i = 0; i < header.heroCount; i++) {
+        HeroSkill skill {(SkillType) heroes[i].skillType, (Element) heroes[i].skillTarget, (Element) heroes[i].skillSource, heroes[i].skillAmount};
+        baseHeroes.push_back(Monster(heroes[i].hp, heroes[i].damage, heroes[i].name, (Element) heroes[i].element, (HeroRarity) heroes[i].rarity, skill));
+    }
+    questMonsterNumbers.clear();
+    for (size_t i = 0; i < header.questCount; i++) {
+        questMonsterNumbers.push_back(vector<int8_t>(questMonsters + questOffsets[i], questMonsters + questOffsets[i+1]));
+    }
+    monsterReplayMap.clear(); // The ingame order is the order of the files
+}
+
+void loadGameData(const string & directory) {
+    string cachePath = joinPath(directory, DATA_CACHE_FILE);
+    time_t cacheTime = modificationTime(cachePath);
+    bool stale = cacheTime < 0;
+    const string files[] {MONSTER_DATA_FILE, HERO_DATA_FILE, QUEST_DATA_FILE};
+    for (size_t i = 0; i < 3; i++) {
+        stale = stale || modificationTime(joinPath(directory, files[i])) > cacheTime;
+    }
+
+    if (stale) {
+        vector<char> bytes = compileGameData(directory);
+        // Write to a temporary file first so other processes never map a half written cache
+        string temporaryPath = cachePath + ".tmp";
+        ofstream cache(temporaryPath, ios::binary | ios::trunc);
+        cache.write(bytes.data(), bytes.size());
+        cache.close();
+        if (!cache || rename(temporaryPath.c_str(), cachePath.c_str()) != 0) {
+            remove(temporaryPath.c_str());
+            useGameData(bytes.data(), bytes.size(), cachePath); // Read only directory, use the data without caching it
+            return;
+        }
+    }
+
+#ifndef _WIN32
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || fstat(fd, &info) != 0) {
+        throw runtime_error("Could not open " + cachePath);
+    }
+    void * data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        throw runtime_error("Could not map " + cachePath);
+    }
+    try {
+        useGameData((const char *) data, info.st_size, cachePath);
+    } catch (...) {
+        munmap(data, info.st_size);
+        throw;
+    }
+    munmap(data, info.st_size);
+#else
+    ifstream cache(cachePath, ios::binary);
+    vector<char> bytes((istreambuf_iterator<char>(cache)), istreambuf_iterator<char>());
+    useGameData(bytes.data(), bytes.size(), cachePath);
+#endif
+}
+
+// Monsters in ingame order. initMonsterData sorts monsterBaseList, monsterReplayMap remembers the original order
+static vector<Monster> monstersInIngameOrder() {
+    vector<Monster> monsters = monsterBaseList;
+    if (!monsterReplayMap.empty()) {
+        for (size_t i = 0; i < monsterBaseList.size(); i++) {
+            monsters[monsterReplayMap.at(monsterBaseList[i].name)] = monsterBaseList[i];
+        }
+    }
+    return monsters;
+}
+
+void exportGameData(const string & directory) {
+    vector<Monster> monsters = monstersInIngameOrder();
+    ofstream monsterFile(joinPath(directory, MONSTER_DATA_FILE));
+    monsterFile << "version 1" << endl;
+    monsterFile << "// name hp damage cost element" << endl;
+    for (size_t i = 0; i < monsters.size(); i++) {
+        monsterFile << monsters[i].name << " " << monsters[i].hp << " " << monsters[i].damage << " " << monsters[i].cost << " " << ELEMENT_NAMES[monsters[i].element] << endl;
+    }
+
+    ofstream heroFile(joinPath(directory, HERO_DATA_FILE));
+    heroFile << "version 1" << endl;
+    heroFile << "// name hp damage element rarity skill target sourceElement amount" << endl;
+    for (size_t i = 0; i < baseHeroes.size(); i++) {
+        const Monster & hero = baseHeroes[i];
+        size_t rarity = 0;
+        while (RARITIES[rarity] != hero.rarity) {
+            rarity++;
+        }
+        heroFile << hero.baseName << " " << hero.hp << " " << hero.damage << " " << ELEMENT_NAMES[hero.element] << " " << RARITY_NAMES[rarity] << " ";
+        heroFile << SKILL_TYPE_NAMES[hero.skill.type] << " " << ELEMENT_NAMES[hero.skill.target] << " " << ELEMENT_NAMES[hero.skill.sourceElement] << " " << hero.skill.amount << endl;
+    }
+
+    ofstream questFile(joinPath(directory, QUEST_DATA_FILE));
+    questFile << "version 1" << endl;
+    questFile << "// questNumber followed by the enemy lineup" << endl;
+    for (size_t i = 0; i < questLineups.size(); i++) {
+        if (!questLineups[i].empty()) {
+            questFile << i;
+            for (size_t j = 0; j < questLineups[i].size(); j++) {
+                questFile << " " << monsterReference[questLineups[i][j]].name;
+            }
+            questFile << endl;
+        }
+    }
+
+    if (!monsterFile || !heroFile || !questFile) {
+        throw runtime_error("Could not write game data to " + directory);
+    }
+}
+
+static string upper(string name) {
+    for (size_t i = 0; i < name.length(); i++) {
+        name[i] = (char) toupper(name[i]);
+    }
+    return name;
+}
+
+// The sorted monsterBaseList of initMonsterData becomes MONSTER_COST_ORDER, so the built in tables need no sorting at runtime
+void exportGameDataHeader(const string & fileName) {
+    vector<Monster> monsters = monstersInIngameOrder();
+    ofstream header(fileName);
+    header << "// Game data as compile time tables, generated with make gamedata from the files in data. Do not edit by hand" << endl;
+    header << "#ifndef COSMOS_GAMEDATA_TABLES_HEADER" << endl;
+    header << "#define COSMOS_GAMEDATA_TABLES_HEADER" << endl << endl;
+
+    header << "constexpr MonsterData MONSTER_DATA[] { // Monsters in ingame order" << endl;
+    for (size_t i = 0; i < monsters.size(); i++) {
+        header << "    {" << monsters[i].hp << ", " << monsters[i].damage << ", " << monsters[i].cost << ", \"" << monsters[i].name << "\", " << upper(ELEMENT_NAMES[monsters[i].element]) << "}," << endl;
+    }
+    header << "};" << endl;
+    header << "constexpr size_t MONSTER_DATA_AMOUNT = sizeof(MONSTER_DATA) / sizeof(MONSTER_DATA[0]);" << endl << endl;
+
+    header << "constexpr int8_t MONSTER_COST_ORDER[MONSTER_DATA_AMOUNT] { // Ingame numbers of the monsters sorted by follower cost" << endl << "    ";
+    for (size_t i = 0; i < monsterBaseList.size(); i++) {
+        header << (int) monsterReplayMap.at(monsterBaseList[i].name) << (i + 1 < monsterBaseList.size() ? ", " : "");
+    }
+    header << endl << "};" << endl << endl;
+
+    header << "constexpr HeroData HERO_DATA[] { // Heroes in ingame order" << endl;
+    for (size_t i = 0; i < baseHeroes.size(); i++) {
+        const Monster & hero = baseHeroes[i];
+        size_t rarity = 0;
+        while (RARITIES[rarity] != hero.rarity) {
+            rarity++;
+        }
+        header << "    {" << hero.hp << ", " << hero.damage << ", \"" << hero.baseName << "\", " << upper(ELEMENT_NAMES[hero.element]) << ", " << upper(RARITY_NAMES[rarity]) << ", ";
+        header << "{" << upper(SKILL_TYPE_NAMES[hero.skill.type]) << ", " << upper(ELEMENT_NAMES[hero.skill.target]) << ", " << upper(ELEMENT_NAMES[hero.skill.sourceElement]) << ", " << hero.skill.amount << "}}," << endl;
+    }
+    header << "};" << endl;
+    header << "constexpr size_t HERO_DATA_AMOUNT = sizeof(HERO_DATA) / sizeof(HERO_DATA[0]);" << endl << endl;
+
+    header << "constexpr int8_t QUEST_DATA[][ARMY_MAX_SIZE] { // Enemy lineups as ingame monster numbers, -1 marks empty spots" << endl;
+    for (size_t i = 0; i < questLineups.size(); i++) {
+        header << "    {";
+        for (size_t j = 0; j < ARMY_MAX_SIZE; j++) {
+            header << (j < questLineups[i].size() ? (int) monsterReplayMap.at(monsterReference[questLineups[i][j]].name) : -1) << (j + 1 < ARMY_MAX_SIZE ? ", " : "");
+        }
+        header << "}, // " << i << endl;
+    }
+    header << "};" << endl;
+    header << "constexpr size_t QUEST_DATA_AMOUNT = sizeof(QUEST_DATA) / sizeof(QUEST_DATA[0]);" << endl << endl;
+    header << "#endif" << endl;
+
+    if (!header) {
+        throw runtime_error("Could not write " + fileName);
+    }
+}
@@ -0,0 +1,27 @@
+#ifndef COSMOS_GAMEDATA_HEADER
+#define COSMOS_GAMEDATA_HEADER
+
+#include <string>
+
+const std::string DATA_FLAG = "-data";
+const std::string EXPORT_DATA_FLAG = "-export-data";
+const std::string EXPORT_HEADER_FLAG = "-export-header";
+
+// Files in a game data directory. Every text file starts with a line "version <number>"
+const std::string MONSTER_DATA_FILE = "monsters.txt";   // name hp damage cost element
+const std::string HERO_DATA_FILE = "heroes.txt";        // name hp damage element rarity skill target sourceElement amount
+const std::string QUEST_DATA_FILE = "quests.txt";       // questNumber monster monster ...
+const std::string DATA_CACHE_FILE = "gamedata.bin";     // Built from the text files, quests already resolved to monster numbers
+
+// Replace the built in monsters, heroes and quests with the files in directory. Must be called before initMonsterData.
+// The text files are compiled into a binary cache next to them the first time and whenever one of them changed,
+// every other start only maps the cache. Throws runtime_error if the files are missing or malformed.
+void loadGameData(const std::string & directory);
+
+// Write the current monsters, heroes and quests as text files into directory, in ingame order
+void exportGameData(const std::string & directory);
+
+// Write the current monsters, heroes and quests as the constexpr tables of cosmosGameData.h. Must be called after initMonsterData
+void exportGameDataHeader(const std::string & fileName);
+
+#endif
@@ -0,0 +1,261 @@
+#include "cosmosDefense.h"
+
+#include <algorithm>
+#include <limits>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+// Cheapest attack against one defensive lineup
+struct DefenseEvaluation {
+    int attackCost = 0;
+    bool unbeaten = false;
+    Army attack;
+    int fights = 0;
+
+    bool isHarderThan(const DefenseEvaluation & other) const {
+        return (this->unbeaten && !other.unbeaten) || (this->unbeaten == other.unbeaten && this->attackCost > other.attackCost);
+    }
+};
+
+static string lineupKey(const vector<MonsterIndex> & lineup) {
+    string key;
+    for (size_t i = 0; i < lineup.size(); i++) {
+        key += to_string(lineup[i]) + ELEMENT_SEPARATOR;
+    }
+    return key;
+}
+
+// Check if a lineup stays within the follower limit and uses every hero only once
+static bool isValidDefense(const vector<MonsterIndex> & lineup, int defenseFollowers) {
+    int cost = 0;
+    for (size_t i = 0; i < lineup.size(); i++) {
+        cost += monsterReference[lineup[i]].cost;
+        if (monsterReference[lineup[i]].rarity != NO_HERO && find(lineup.begin(), lineup.begin() + i, lineup[i]) != lineup.begin() + i) {
+            return false;
+        }
+    }
+    return cost <= defenseFollowers;
+}
+
+// Solve the attack on a lineup with the attacker's context. Runs in its own thread, so the context is a copy with its own quiet output
+static void evaluateDefense(const vector<MonsterIndex> & lineup, SolverContext attacker, int attackerFollowers, DefenseEvaluation & evaluation) {
+    IOManager quiet;
+    quiet.outputLevel = SOLUTION_OUTPUT;
+    attacker.io = &quiet;
+
+    Instance attack;
+    attack.target = Army(lineup);
+    attack.targetSize = lineup.size();
+    attack.maxCombatants = ARMY_MAX_SIZE;
+    attack.followerUpperBound = attackerFollowers;
+    solveInstance(attack, attacker);
+
+    evaluation.unbeaten = attack.bestSolution.isEmpty();
+    evaluation.attackCost = evaluation.unbeaten ? attackerFollowers : attack.bestSolution.followerCost;
+    evaluation.attack = attack.bestSolution;
+    evaluation.fights = attack.totalFightsSimulated;
+}
+
+// Evaluates lineups in parallel and remembers every result
+class DefenseEvaluator {
+    private:
+        SolverContext attacker;
+        int attackerFollowers;
+        unordered_map<string, DefenseEvaluation> cache;
+
+    public:
+        int evaluations = 0;
+        int cacheHits = 0;
+        int fights = 0;
+
+        DefenseEvaluator(SolverContext & context, int someAttackerFollowers) :
+            attacker(context),
+            attackerFollowers(someAttackerFollowers)
+        {
+            this->attacker.availableMonsters = filterMonsterData(0);
+            this->attacker.availableHeroes.clear();
+            this->attacker.solutionAmount = 1;
+            this->attacker.paretoCriteria = NO_PARETO;
+            this->attacker.perfCounters = false;
+            this->attacker.trace = nullptr;
+            this->attacker.progress = nullptr;
+            this->attacker.onNewSolution = nullptr;
+            this->attacker.onProgress = [](const Instance & instance, size_t, size_t, size_t) {
+                return instance.totalFightsSimulated < DEFENSE_FIGHT_BUDGET;
+            };
+        }
+
+        vector<DefenseEvaluation> evaluate(const vector<vector<MonsterIndex>> & lineups) {
+            vector<DefenseEvaluation> results(lineups.size());
+            vector<size_t> pending;
+            for (size_t i = 0; i < lineups.size(); i++) {
+                auto known = this->cache.find(lineupKey(lineups[i]));
+                if (known != this->cache.end()) {
+                    results[i] = known->second;
+                    this->cacheHits++;
+                } else {
+                    pending.push_back(i);
+                }
+            }
+
+            size_t threadAmount = max(1u, thread::hardware_concurrency());
+            for (size_t start = 0; start < pending.size(); start += threadAmount) {
+                vector<thread> workers;
+                for (size_t i = start; i < pending.size() && i < start + threadAmount; i++) {
+                    workers.push_back(thread(evaluateDefense, cref(lineups[pending[i]]), this->attacker, this->attackerFollowers, ref(results[pending[i]])));
+                }
+                for (size_t i = 0; i < workers.size(); i++) {
+                    workers[i].join();
+                }
+            }
+            for (size_t i = 0; i < pending.size(); i++) {
+                this->cache[lineupKey(lineups[pending[i]])] = results[pending[i]];
+                this->evaluations++;
+                this->fights += results[pending[i]].fights;
+            }
+            return results;
+        }
+};
+
+DefenseResult searchDefense(SolverContext & context, int defenseFollowers, int attackerFollowers) {
+    time_t startTime = time(NULL);
+    if (defenseFollowers < 0) {
+        defenseFollowers = numeric_limits<int>::max();
+    }
+    if (attackerFollowers < 0) {
+        attackerFollowers = numeric_limits<int>::max();
+    }
+    vector<MonsterIndex> pool = context.availableMonsters;
+    pool.insert(pool.end(), context.availableHeroes.begin(), context.availableHeroes.end());
+    if (pool.empty()) {
+        throw runtime_error("There are no monsters or heroes to defend with");
+    }
+    DefenseEvaluator evaluator(context, attackerFollowers);
+    mt19937 random(DEFENSE_SEED);
+
+    // Start with the strongest units that fit, the cheapest monster fills up if the limit is reached
+    vector<MonsterIndex> strongest = pool;
+    sort(strongest.begin(), strongest.end(), [](MonsterIndex a, MonsterIndex b) {
+        return (int64_t) monsterReference[a].hp * monsterReference[a].damage > (int64_t) monsterReference[b].hp * monsterReference[b].damage;
+    });
+    int cheapest = 0; // Heroes can't be repeated, so the slots left over are filled with monsters
+    for (size_t i = 0; i < context.availableMonsters.size(); i++) {
+        if (i == 0 || monsterReference[context.availableMonsters[i]].cost < cheapest) {
+            cheapest = monsterReference[context.availableMonsters[i]].cost;
+        }
+    }
+    vector<MonsterIndex> current;
+    for (size_t slot = 0; slot < ARMY_MAX_SIZE; slot++) {
+        for (size_t i = 0; i < strongest.size(); i++) {
+            current.push_back(strongest[i]);
+            int reserve = (int) (ARMY_MAX_SIZE - current.size()) * cheapest;
+            if (isValidDefense(current, defenseFollowers - reserve)) {
+                break;
+            }
+            current.pop_back();
+        }
+        if (current.size() <= slot) {
+            throw runtime_error("Can't build a lineup of " + to_string(ARMY_MAX_SIZE) + " units within " + to_string(defenseFollowers) + " followers");
+        }
+    }
+    DefenseEvaluation currentScore = evaluator.evaluate({current})[0];
+    vector<MonsterIndex> best = current;
+    DefenseEvaluation bestScore = currentScore;
+    context.io->outputMessage("Starting defense " + Army(current).toString() + " needs " + to_string(currentScore.attackCost) + " followers", CMD_OUTPUT);
+
+    // Local search: move to the best neighbor that is harder to beat, jump after a few rounds without progress
+    uniform_int_distribution<size_t> slotDistribution(0, ARMY_MAX_SIZE - 1);
+    uniform_int_distribution<size_t> unitDistribution(0, pool.size() - 1);
+    int staleRounds = 0;
+    for (int round = 0; round < DEFENSE_ROUNDS; round++) {
+        vector<vector<MonsterIndex>> neighbors;
+        for (size_t tries = 0; neighbors.size() < DEFENSE_NEIGHBORS && tries < DEFENSE_NEIGHBORS * 20; tries++) {
+            vector<MonsterIndex> neighbor = current;
+            if (tries % 3 == 2) {
+                swap(neighbor[slotDistribution(random)], neighbor[slotDistribution(random)]); // Order matters as much as the units
+            } else {
+                neighbor[slotDistribution(random)] = pool[unitDistribution(random)];
+            }
+            if (neighbor != current && isValidDefense(neighbor, defenseFollowers) && find(neighbors.begin(), neighbors.end(), neighbor) == neighbors.end()) {
+                neighbors.push_back(neighbor);
+            }
+        }
+        vector<DefenseEvaluation> scores = evaluator.evaluate(neighbors);
+
+        size_t bestNeighbor = neighbors.size();
+        for (size_t i = 0; i < neighbors.size(); i++) {
+            if (scores[i].isHarderThan(bestNeighbor < neighbors.size() ? scores[bestNeighbor] : currentScore)) {
+                bestNeighbor = i;
+            }
+        }
+        if (bestNeighbor < neighbors.size()) {
+            current = neighbors[bestNeighbor];
+            currentScore = scores[bestNeighbor];
+            staleRounds = 0;
+        } else if (++staleRounds >= DEFENSE_STALE_ROUNDS) {
+            // Continue from a random neighbor of the best lineup so far, the search may have drifted away from it
+            vector<MonsterIndex> jump = best;
+            for (size_t tries = 0; jump == best && tries < DEFENSE_NEIGHBORS * 20; tries++) {
+                vector<MonsterIndex> neighbor = best;
+                neighbor[slotDistribution(random)] = pool[unitDistribution(random)];
+                if (isValidDefense(neighbor, defenseFollowers)) {
+                    jump = neighbor;
+                }
+            }
+            current = jump;
+            currentScore = jump == best ? bestScore : evaluator.evaluate({jump})[0];
+            staleRounds = 0;
+        }
+        if (currentScore.isHarderThan(bestScore)) {
+            best = current;
+            bestScore = currentScore;
+            context.io->outputMessage("Round " + to_string(round + 1) + ": " + Army(best).toString() + " needs " + to_string(bestScore.attackCost) + " followers", CMD_OUTPUT);
+        }
+    }
+
+    DefenseResult result;
+    result.lineup = Army(best);
+    result.attackCost = bestScore.attackCost;
+    result.unbeaten = bestScore.unbeaten;
+    result.attack = bestScore.attack;
+    result.evaluations = evaluator.evaluations;
+    result.cacheHits = evaluator.cacheHits;
+    result.totalFightsSimulated = evaluator.fights;
+    result.calculationTime = time(NULL) - startTime;
+    return result;
+}
+
+string DefenseResult::toString() {
+    stringstream s;
+
+    s << endl << "Hardest lineup to beat:" << endl;
+    s << "  " << this->lineup.toString() << endl;
+    if (this->unbeaten) {
+        s << "  No attack within the attacker limit was found." << endl;
+    } else {
+        s << "  Cheapest attack found: " << this->attack.toString() << endl;
+    }
+    s << "  " << this->evaluations << " Lineups solved, " << this->cacheHits << " taken from the cache." << endl;
+    s << "  " << this->totalFightsSimulated << " Fights simulated." << endl;
+    s << "  Total Calculation Time: " << this->calculationTime << endl << endl;
+
+    return s.str();
+}
+
+string DefenseResult::toJSON() {
+    stringstream s;
+    s << "{";
+        s << "\"defense\"" << ":" << this->lineup.toJSON() << ",";
+        s << "\"attackCost\"" << ":" << this->attackCost << ",";
+        s << "\"unbeaten\"" << ":" << (this->unbeaten ? "true" : "false") << ",";
+        s << "\"attack\"" << ":" << this->attack.toJSON() << ",";
+        s << "\"evaluations\"" << ":" << this->evaluations << ",";
+        s << "\"cacheHits\"" << ":" << this->cacheHits << ",";
+        s << "\"fights\"" << ":" << this->totalFightsSimulated << ",";
+        s << "\"time\"" << ":" << this->calculationTime;
+    s << "}";
+    return s.str();
+}
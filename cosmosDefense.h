@@ -0,0 +1,40 @@
+#ifndef COSMOS_DEFENSE_HEADER
+#define COSMOS_DEFENSE_HEADER
+
+#include <string>
+#include <vector>
+#include <ctime>
+
+#include "cosmosClasses.h"
+#include "inputProcessing.h"
+#include "solver.h"
+
+const std::string DEFENSE_FLAG = "-defense";
+
+const int DEFENSE_ROUNDS = 40;              // Rounds of local search, every round evaluates one batch of neighbors
+const size_t DEFENSE_NEIGHBORS = 16;        // Neighbors evaluated per round
+const int DEFENSE_STALE_ROUNDS = 4;         // Rounds without improvement before the search jumps somewhere else
+const int DEFENSE_FIGHT_BUDGET = 2000000;   // Fights an inner solve may simulate before it settles for the best attack found so far
+const unsigned DEFENSE_SEED = 42;           // The search is random but repeatable
+
+// The hardest lineup to beat that a local search found
+struct DefenseResult {
+    Army lineup;
+    int attackCost = 0;         // Followers of the cheapest attack found, the attacker limit if none was found
+    bool unbeaten = false;      // No attack within the attacker limit was found
+    Army attack;
+    int evaluations = 0;        // Inner solves
+    int cacheHits = 0;
+    int totalFightsSimulated = 0;
+    time_t calculationTime;
+
+    std::string toString();
+    std::string toJSON();
+};
+
+// Search for the lineup of the context's monsters and heroes that costs at most defenseFollowers and needs the most followers to beat.
+// Attackers use every monster but no heroes and at most attackerFollowers. Every candidate is scored by a full solve with a fight budget,
+// solves run in parallel and are cached
+DefenseResult searchDefense(SolverContext & context, int defenseFollowers, int attackerFollowers);
+
+#endif
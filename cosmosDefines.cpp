@@ -1,42 +1,164 @@
 #include "cosmosDefines.h"
 
-std::map<std::string, int8_t> monsterMap {}; // Maps monster Names to their indices in monsterReference from cosmosClasses
+std::unordered_map<std::string, MonsterIndex> monsterMap {}; // Maps monster Names to their indices in monsterReference from cosmosClasses
+std::unordered_map<std::string, int8_t> heroMap {}; // Maps hero base names to their indices in baseHeroes
+std::unordered_map<std::string, int8_t> monsterReplayMap {}; // Maps monster Names to their ingame indices used in replays
 
-std::vector<int8_t> availableMonsters {}; // Contains indices of raw Monster Data from a1 to f15, will be sorted by follower cost
-std::vector<int8_t> availableHeroes {}; // Contains all user heroes' indices 
+static std::unordered_map<uint64_t, MonsterIndex> leveledHeroMap {}; // Maps hero index and level to the index of the leveled hero in monsterReference
 
-// Clean up all monster related vectors and sort the monsterBaseList
-// Also fills the map used to parse strings into monsters
+std::vector<Monster> monsterBaseList {}; // Raw Monster Data, holds the actual Objects. Filled from MONSTER_DATA unless loaded from files
+std::vector<Monster> baseHeroes {}; // Raw, unleveld Hero Data, holds actual Objects. Filled from HERO_DATA unless loaded from files
+std::vector<std::vector<int8_t>> questMonsterNumbers {}; // Quest lineups as ingame monster numbers
+std::vector<std::vector<MonsterIndex>> questLineups {}; // Quest lineups resolved to indices in monsterReference by initMonsterData
+std::vector<HeroStats> heroStatTable {}; // Stats of every base hero at every level, HERO_TABLE_MAX_LEVEL entries per hero
+
+std::mutex monsterReferenceMutex; // Guards additions to monsterReference when several solvers share a process
+
+thread_local std::set<MonsterIndex> * leveledHeroOwner = nullptr;
+static std::vector<int> leveledHeroOwners {};       // Owners holding every entry of monsterReference
+static std::vector<bool> pinnedHeroes {};           // Entries added without an owner, they are never released
+static std::vector<MonsterIndex> freeHeroSlots {};  // Released entries of monsterReference that new leveled heroes reuse
+
+// Fill the monsterBaseList from the built in tables or sort it if it was loaded from files
+// Also fills the map used to parse strings into monsters and resolves the quests
 // Must be called before any input can be processed
 void initMonsterData() {
-    // Sort MonsterList by followers
-    sort(monsterBaseList.begin(), monsterBaseList.end(), isCheaper);
+    if (monsterBaseList.empty()) {
+        // Built in data, MONSTER_COST_ORDER is already sorted by followers
+        for (size_t i = 0; i < MONSTER_DATA_AMOUNT; i++) {
+            const MonsterData & data = MONSTER_DATA[MONSTER_COST_ORDER[i]];
+            monsterBaseList.push_back(Monster(data.hp, data.damage, data.cost, data.name, data.element));
+        }
+        monsterReplayMap.clear();
+        for (size_t i = 0; i < MONSTER_DATA_AMOUNT; i++) {
+            monsterReplayMap.insert(std::pair<std::string, int8_t>(MONSTER_DATA[i].name, i));
+        }
+        baseHeroes.clear();
+        for (size_t i = 0; i < HERO_DATA_AMOUNT; i++) {
+            const HeroData & data = HERO_DATA[i];
+            baseHeroes.push_back(Monster(data.hp, data.damage, data.name, data.element, data.rarity, data.skill));
+        }
+        questMonsterNumbers.clear();
+        for (size_t i = 0; i < QUEST_DATA_AMOUNT; i++) {
+            questMonsterNumbers.push_back({});
+            for (size_t j = 0; j < ARMY_MAX_SIZE && QUEST_DATA[i][j] >= 0; j++) {
+                questMonsterNumbers[i].push_back(QUEST_DATA[i][j]);
+            }
+        }
+    } else if (monsterReplayMap.empty()) {
+        // Data loaded from files is in ingame order, so remember it before sorting
+        for (size_t i = 0; i < monsterBaseList.size(); i++) {
+            monsterReplayMap.insert(std::pair<std::string, int8_t>(monsterBaseList[i].name, i));
+        }
+        // Sort MonsterList by followers
+        sort(monsterBaseList.begin(), monsterBaseList.end(), isCheaper);
+    }
 
     // Initialize Monster Data
     monsterReference.clear();
+    monsterReference.reserve(MONSTER_REFERENCE_CAPACITY); // Never reallocate so concurrent readers stay valid
     monsterMap.clear();
     for (size_t i = 0; i < monsterBaseList.size(); i++) {
         monsterReference.push_back(monsterBaseList[i]);
-        monsterMap.insert(std::pair<std::string, int8_t>(monsterBaseList[i].name, i));
+        monsterMap.insert(std::pair<std::string, MonsterIndex>(monsterBaseList[i].name, i));
+    }
+    leveledHeroMap.clear();
+    leveledHeroOwners.assign(MONSTER_REFERENCE_CAPACITY, 0);
+    pinnedHeroes.assign(MONSTER_REFERENCE_CAPACITY, false);
+    freeHeroSlots.clear();
+    heroMap.clear();
+    for (size_t i = 0; i < baseHeroes.size(); i++) {
+        heroMap.insert(std::pair<std::string, int8_t>(baseHeroes[i].baseName, i));
+    }
+    
+    // Level every hero once so level scans only need a table lookup
+    heroStatTable.clear();
+    heroStatTable.reserve(baseHeroes.size() * HERO_TABLE_MAX_LEVEL);
+    for (size_t i = 0; i < baseHeroes.size(); i++) {
+        for (int level = 1; level <= HERO_TABLE_MAX_LEVEL; level++) {
+            heroStatTable.push_back(levelHeroStats(baseHeroes[i].hp, baseHeroes[i].damage, baseHeroes[i].rarity, level));
+        }
+    }
+    
+    // Resolve quests once so instances don't parse monster names
+    std::vector<MonsterIndex> byMonsterNumber(monsterBaseList.size());
+    for (size_t i = 0; i < monsterBaseList.size(); i++) {
+        byMonsterNumber[monsterReplayMap.at(monsterBaseList[i].name)] = (MonsterIndex) i;
+    }
+    questLineups.clear();
+    for (size_t i = 0; i < questMonsterNumbers.size(); i++) {
+        questLineups.push_back({});
+        for (size_t j = 0; j < questMonsterNumbers[i].size(); j++) {
+            questLineups[i].push_back(byMonsterNumber.at(questMonsterNumbers[i][j]));
+        }
     }
-
-    availableMonsters.clear();
-    availableHeroes.clear();
 }
 
-// Filter MonsterList by cost. User can specify if he wants to exclude cheap monsters
-void filterMonsterData(int minimumMonsterCost) {
+// Filter MonsterList by cost and return the indices of all usable monsters. User can specify if he wants to exclude cheap monsters
+std::vector<MonsterIndex> filterMonsterData(int minimumMonsterCost) {
+    std::vector<MonsterIndex> availableMonsters;
     for (size_t i = 0; i < monsterBaseList.size(); i++) {
         if (minimumMonsterCost <= monsterBaseList[i].cost) {
-            availableMonsters.push_back((int8_t) i); // Kinda Dirty but I know that the normal mobs come first in the reference
+            availableMonsters.push_back((MonsterIndex) i); // Kinda Dirty but I know that the normal mobs come first in the reference
         }
     }
+    return availableMonsters;
+}
+
+// Approximate bytes held by monsterReference and monsterMap including their strings
+size_t monsterDataBytes() {
+    std::lock_guard<std::mutex> lock(monsterReferenceMutex);
+    size_t bytes = monsterReference.capacity() * sizeof(Monster);
+    for (size_t i = 0; i < monsterReference.size(); i++) {
+        bytes += monsterReference[i].name.capacity() + monsterReference[i].baseName.capacity();
+    }
+    bytes += monsterMap.bucket_count() * sizeof(void *); // Bucket array
+    for (auto it = monsterMap.begin(); it != monsterMap.end(); it++) {
+        bytes += sizeof(*it) + it->first.capacity() + sizeof(void *) + sizeof(size_t); // Node with its next pointer and cached hash
+    }
+    bytes += heroStatTable.capacity() * sizeof(HeroStats);
+    return bytes;
 }
 
 // Add a leveled hero to the databse and return its corresponding index
-int8_t addLeveledHero(Monster & hero, int level) {
-    Monster m(hero, level);
-    monsterReference.emplace_back(m);
+// Every combination of hero and level is only added once, repeated calls return the same index
+MonsterIndex addLeveledHero(size_t baseHeroIndex, int level) {
+    uint64_t key = ((uint64_t) baseHeroIndex << 32) | (uint32_t) level;
+    std::lock_guard<std::mutex> lock(monsterReferenceMutex);
+    MonsterIndex index;
+    auto known = leveledHeroMap.find(key);
+    if (known != leveledHeroMap.end()) {
+        index = known->second;
+    } else if (!freeHeroSlots.empty()) {
+        index = freeHeroSlots.back();
+        freeHeroSlots.pop_back();
+        monsterReference[index] = Monster(baseHeroes.at(baseHeroIndex), level);
+        leveledHeroMap.insert(std::pair<uint64_t, MonsterIndex>(key, index));
+    } else {
+        if (monsterReference.size() >= MONSTER_REFERENCE_CAPACITY) {
+            throw std::length_error("Too many leveled heroes for " + std::to_string(MONSTER_INDEX_BITS) + " bit monster indices. Rebuild with make INDEX_BITS=16");
+        }
+        monsterReference.emplace_back(baseHeroes.at(baseHeroIndex), level);
+        index = (MonsterIndex) (monsterReference.size() - 1);
+        leveledHeroMap.insert(std::pair<uint64_t, MonsterIndex>(key, index));
+    }
     
-    return (int8_t) (monsterReference.size() - 1);
+    if (leveledHeroOwner == nullptr) {
+        pinnedHeroes[index] = true;
+    } else if (leveledHeroOwner->insert(index).second) {
+        leveledHeroOwners[index]++;
+    }
+    return index;
+}
+
+// Give up an owner's leveled heroes. Entries that no other owner holds are reused by later calls to addLeveledHero
+void releaseLeveledHeroes(const std::set<MonsterIndex> & heroes) {
+    std::lock_guard<std::mutex> lock(monsterReferenceMutex);
+    for (auto hero = heroes.begin(); hero != heroes.end(); hero++) {
+        if (--leveledHeroOwners[*hero] == 0 && !pinnedHeroes[*hero]) {
+            const Monster & monster = monsterReference[*hero];
+            leveledHeroMap.erase(((uint64_t) heroMap.at(monster.baseName) << 32) | (uint32_t) monster.level);
+            freeHeroSlots.push_back(*hero);
+        }
+    }
 }
\ No newline at end of file
@@ -0,0 +1,191 @@
+// Game data as compile time tables, generated with make gamedata from the files in data. Do not edit by hand
+#ifndef COSMOS_GAMEDATA_TABLES_HEADER
+#define COSMOS_GAMEDATA_TABLES_HEADER
+
+constexpr MonsterData MONSTER_DATA[] { // Monsters in ingame order
+    {20, 8, 1000, "a1", AIR},
+    {44, 4, 1300, "e1", EARTH},
+    {16, 10, 1000, "f1", FIRE},
+    {30, 6, 1400, "w1", WATER},
+    {48, 6, 3900, "a2", AIR},
+    {30, 8, 2700, "e2", EARTH},
+    {18, 16, 3900, "f2", FIRE},
+    {24, 12, 3900, "w2", WATER},
+    {36, 12, 8000, "a3", AIR},
+    {26, 16, 7500, "e3", EARTH},
+    {54, 8, 8000, "f3", FIRE},
+    {18, 24, 8000, "w3", WATER},
+    {24, 26, 15000, "a4", AIR},
+    {72, 10, 18000, "e4", EARTH},
+    {52, 16, 23000, "f4", FIRE},
+    {36, 20, 18000, "w4", WATER},
+    {60, 20, 41000, "a5", AIR},
+    {36, 40, 54000, "e5", EARTH},
+    {42, 24, 31000, "f5", FIRE},
+    {78, 18, 52000, "w5", WATER},
+    {62, 34, 96000, "a6", AIR},
+    {72, 24, 71000, "e6", EARTH},
+    {104, 20, 94000, "f6", FIRE},
+    {44, 44, 84000, "w6", WATER},
+    {106, 26, 144000, "a7", AIR},
+    {66, 36, 115000, "e7", EARTH},
+    {54, 44, 115000, "f7", FIRE},
+    {92, 32, 159000, "w7", WATER},
+    {78, 52, 257000, "a8", AIR},
+    {60, 60, 215000, "e8", EARTH},
+    {94, 50, 321000, "f8", FIRE},
+    {108, 36, 241000, "w8", WATER},
+    {116, 54, 495000, "a9", AIR},
+    {120, 48, 436000, "e9", EARTH},
+    {102, 58, 454000, "f9", FIRE},
+    {80, 70, 418000, "w9", WATER},
+    {142, 60, 785000, "a10", AIR},
+    {122, 64, 689000, "e10", EARTH},
+    {104, 82, 787000, "f10", FIRE},
+    {110, 70, 675000, "w10", WATER},
+    {114, 110, 1403000, "a11", AIR},
+    {134, 81, 1130000, "e11", EARTH},
+    {164, 70, 1229000, "f11", FIRE},
+    {152, 79, 1315000, "w11", WATER},
+    {164, 88, 1733000, "a12", AIR},
+    {128, 120, 1903000, "e12", EARTH},
+    {156, 92, 1718000, "f12", FIRE},
+    {188, 78, 1775000, "w12", WATER},
+    {210, 94, 2772000, "a13", AIR},
+    {190, 132, 3971000, "e13", EARTH},
+    {166, 130, 3169000, "f13", FIRE},
+    {140, 128, 2398000, "w13", WATER},
+    {200, 142, 4785000, "a14", AIR},
+    {244, 136, 6044000, "e14", EARTH},
+    {168, 168, 4741000, "f14", FIRE},
+    {212, 122, 4159000, "w14", WATER},
+    {226, 190, 8897000, "a15", AIR},
+    {200, 186, 7173000, "e15", EARTH},
+    {234, 136, 5676000, "f15", FIRE},
+    {276, 142, 7758000, "w15", WATER},
+};
+constexpr size_t MONSTER_DATA_AMOUNT = sizeof(MONSTER_DATA) / sizeof(MONSTER_DATA[0]);
+
+constexpr int8_t MONSTER_COST_ORDER[MONSTER_DATA_AMOUNT] { // Ingame numbers of the monsters sorted by follower cost
+    2, 0, 1, 3, 5, 4, 6, 7, 9, 10, 11, 8, 12, 13, 15, 14, 18, 16, 19, 17, 21, 23, 22, 20, 25, 26, 24, 27, 29, 31, 28, 30, 35, 33, 34, 32, 39, 37, 36, 38, 41, 42, 43, 40, 46, 44, 47, 45, 51, 48, 50, 49, 55, 54, 52, 58, 53, 57, 59, 56
+};
+
+constexpr HeroData HERO_DATA[] { // Heroes in ingame order
+    {45, 20, "ladyoftwilight", AIR, COMMON, {PROTECT, ALL, AIR, 1}},
+    {70, 30, "tiny", EARTH, RARE, {AOE, ALL, EARTH, 2}},
+    {90, 40, "nebra", FIRE, LEGENDARY, {BUFF, ALL, FIRE, 8}},
+    {20, 10, "valor", AIR, COMMON, {PROTECT, AIR, AIR, 1}},
+    {30, 8, "rokka", EARTH, COMMON, {PROTECT, EARTH, EARTH, 1}},
+    {24, 12, "pyromancer", FIRE, COMMON, {PROTECT, FIRE, FIRE, 1}},
+    {50, 6, "bewat", WATER, COMMON, {PROTECT, WATER, WATER, 1}},
+    {22, 14, "hunter", AIR, COMMON, {BUFF, AIR, AIR, 2}},
+    {40, 20, "shaman", EARTH, RARE, {PROTECT, EARTH, EARTH, 2}},
+    {82, 22, "alpha", FIRE, LEGENDARY, {AOE, ALL, FIRE, 1}},
+    {28, 12, "carl", WATER, COMMON, {BUFF, WATER, WATER, 2}},
+    {38, 22, "nimue", AIR, RARE, {PROTECT, AIR, AIR, 2}},
+    {70, 26, "athos", EARTH, LEGENDARY, {PROTECT, ALL, EARTH, 2}},
+    {24, 16, "jet", FIRE, COMMON, {BUFF, FIRE, FIRE, 2}},
+    {36, 24, "geron", WATER, RARE, {PROTECT, WATER, WATER, 2}},
+    {46, 40, "rei", AIR, LEGENDARY, {BUFF, ALL, AIR, 2}},
+    {19, 22, "ailen", EARTH, COMMON, {BUFF, EARTH, EARTH, 2}},
+    {50, 18, "faefyr", FIRE, RARE, {PROTECT, FIRE, FIRE, 2}},
+    {60, 32, "auri", WATER, LEGENDARY, {HEAL, ALL, WATER, 2}},
+    {22, 32, "nicte", AIR, RARE, {BUFF, AIR, AIR, 4}},
+    {50, 12, "james", EARTH, LEGENDARY, {P_AOE, ALL, EARTH, 1}},
+    {28, 16, "k41ry", AIR, COMMON, {BUFF, AIR, AIR, 3}},
+    {46, 20, "t4urus", EARTH, RARE, {BUFF, ALL, EARTH, 1}},
+    {100, 20, "tr0n1x", FIRE, LEGENDARY, {AOE, ALL, FIRE, 3}},
+    {58, 8, "aquortis", WATER, COMMON, {BUFF, WATER, WATER, 3}},
+    {30, 32, "aeris", AIR, RARE, {HEAL, ALL, AIR, 1}},
+    {75, 2, "geum", EARTH, LEGENDARY, {BERSERK, SELF, EARTH, 2}},
+    {46, 16, "forestdruid", EARTH, RARE, {BUFF, EARTH, EARTH, 4}},
+    {32, 24, "ignitor", FIRE, RARE, {BUFF, FIRE, FIRE, 4}},
+    {58, 14, "undine", WATER, RARE, {BUFF, WATER, WATER, 4}},
+    {38, 12, "rudean", FIRE, COMMON, {BUFF, FIRE, FIRE, 3}},
+    {18, 50, "aural", WATER, RARE, {BERSERK, SELF, WATER, 1.2}},
+    {46, 46, "geror", AIR, LEGENDARY, {FRIENDS, SELF, AIR, 1.2}},
+    {66, 44, "veildur", EARTH, LEGENDARY, {CHAMPION, ALL, EARTH, 3}},
+    {72, 48, "brynhildr", AIR, LEGENDARY, {CHAMPION, ALL, AIR, 4}},
+    {78, 52, "groth", FIRE, LEGENDARY, {CHAMPION, ALL, FIRE, 5}},
+    {30, 16, "ourea", EARTH, COMMON, {BUFF, EARTH, EARTH, 3}},
+    {48, 20, "erebus", FIRE, RARE, {CHAMPION, FIRE, FIRE, 2}},
+    {62, 36, "pontus", WATER, LEGENDARY, {ADAPT, WATER, WATER, 2}},
+    {52, 20, "chroma", AIR, RARE, {PROTECT, AIR, AIR, 4}},
+    {26, 44, "petry", EARTH, RARE, {PROTECT, EARTH, EARTH, 4}},
+    {58, 22, "zaytus", FIRE, RARE, {PROTECT, FIRE, FIRE, 4}},
+    {75, 45, "spyke", AIR, LEGENDARY, {TRAINING, SELF, AIR, 5}},
+    {70, 55, "aoyuki", WATER, LEGENDARY, {RAINBOW, SELF, WATER, 50}},
+    {50, 100, "gaiabyte", EARTH, LEGENDARY, {WITHER, SELF, EARTH, 0.5}},
+    {36, 14, "oymos", AIR, COMMON, {BUFF, AIR, AIR, 4}},
+    {32, 32, "xarth", EARTH, RARE, {CHAMPION, EARTH, EARTH, 2}},
+    {76, 32, "atzar", FIRE, LEGENDARY, {ADAPT, FIRE, FIRE, 2}},
+    {70, 42, "zeth", WATER, LEGENDARY, {REVENGE, ALL, WATER, 0.1}},
+    {76, 46, "koth", EARTH, LEGENDARY, {REVENGE, ALL, EARTH, 0.15}},
+    {82, 50, "gurth", AIR, LEGENDARY, {REVENGE, ALL, AIR, 0.2}},
+    {35, 25, "werewolf", EARTH, COMMON, {PROTECT_L, ALL, EARTH, 9}},
+    {55, 35, "jackoknight", AIR, RARE, {BUFF_L, ALL, AIR, 9}},
+    {75, 45, "dullahan", FIRE, LEGENDARY, {CHAMPION_L, ALL, FIRE, 9}},
+};
+constexpr size_t HERO_DATA_AMOUNT = sizeof(HERO_DATA) / sizeof(HERO_DATA[0]);
+
+constexpr int8_t QUEST_DATA[][ARMY_MAX_SIZE] { // Enemy lineups as ingame monster numbers, -1 marks empty spots
+    {-1, -1, -1, -1, -1, -1}, // 0
+    {19, -1, -1, -1, -1, -1}, // 1
+    {2, 0, 2, 0, 2, 0}, // 2
+    {18, 16, -1, -1, -1, -1}, // 3
+    {6, 4, 5, 7, 10, 8}, // 4
+    {11, 9, 11, 9, 11, 9}, // 5
+    {15, 1, 12, 14, 3, 13}, // 6
+    {18, 16, 14, 8, 6, 0}, // 7
+    {13, 15, 19, 17, 15, 13}, // 8
+    {19, 18, 17, 16, 15, 14}, // 9
+    {19, 17, 16, 18, 17, 19}, // 10
+    {18, 22, 17, 21, 16, 20}, // 11
+    {17, 19, 18, 21, 22, 23}, // 12
+    {28, 24, 20, 16, 12, 8}, // 13
+    {26, 22, 18, 25, 21, 21}, // 14
+    {19, 21, 23, 29, 31, -1}, // 15
+    {32, 30, 28, -1, -1, -1}, // 16
+    {19, 21, 27, 29, 31, -1}, // 17
+    {26, 22, 20, 18, 24, 28}, // 18
+    {25, 35, 34, 33, -1, -1}, // 19
+    {6, 12, 18, 24, 30, 36}, // 20
+    {39, 36, 39, -1, -1, -1}, // 21
+    {35, 37, 38, -1, -1, -1}, // 22
+    {33, 32, 31, 30, 29, -1}, // 23
+    {22, 24, 26, 28, 30, 32}, // 24
+    {31, 27, 31, 31, 27, 31}, // 25
+    {32, 27, 31, 25, 29, 38}, // 26
+    {33, 34, 35, 26, 27, 27}, // 27
+    {36, 28, 32, 36, 32, -1}, // 28
+    {36, 27, 26, 29, 32, 32}, // 29
+    {37, 37, 37, 38, -1, -1}, // 30
+    {33, 38, 34, 34, 36, 24}, // 31
+    {3, 32, 38, 33, 36, 39}, // 32
+    {33, 32, 32, 34, 32, 38}, // 33
+    {30, 33, 35, 32, 36, 36}, // 34
+    {31, 31, 39, 36, 36, 38}, // 35
+    {28, 36, 38, 36, 36, 36}, // 36
+    {29, 36, 37, 38, 38, 37}, // 37
+    {38, 37, 39, 36, 39, 39}, // 38
+    {35, 36, 39, 37, 36, 36}, // 39
+    {39, 36, 39, 36, 39, 36}, // 40
+    {45, 41, 40, 42, 44, -1}, // 41
+    {40, 40, 41, 40, 41, 40}, // 42
+    {28, 40, 36, 39, 44, 45}, // 43
+    {36, 38, 44, 38, 36, 46}, // 44
+    {15, 41, 44, 44, 43, 44}, // 45
+    {40, 44, 40, 42, 40, 38}, // 46
+    {46, 43, 45, 44, 47, -1}, // 47
+    {40, 40, 45, 40, 40, 48}, // 48
+    {48, 50, 50, 50, -1, -1}, // 49
+    {46, 46, 46, 46, 46, 46}, // 50
+    {40, 41, 48, 40, 41, 48}, // 51
+    {50, 51, 48, 46, 46, -1}, // 52
+    {32, 50, 50, 46, 44, 44}, // 53
+    {48, 48, 44, 44, 42, 46}, // 54
+    {40, 38, 40, 53, 50, 40}, // 55
+};
+constexpr size_t QUEST_DATA_AMOUNT = sizeof(QUEST_DATA) / sizeof(QUEST_DATA[0]);
+
+#endif
@@ -0,0 +1,129 @@
+#include "cosmosMetrics.h"
+
+#include <sstream>
+#include <iomanip>
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+int64_t LevelMetrics::totalNanoseconds() const {
+    int64_t total = 0;
+    for (size_t i = 0; i < PHASE_AMOUNT; i++) {
+        total += this->phaseNanoseconds[i];
+    }
+    return total;
+}
+
+string LevelMetrics::toJSON() const {
+    stringstream s;
+    int64_t simulateNanoseconds = this->phaseNanoseconds[SIMULATE_PURE_PHASE] + this->phaseNanoseconds[SIMULATE_HERO_PHASE];
+    s << "{";
+        s << "\"armySize\"" << ":" << this->armySize << ",";
+        s << "\"phases\"" << ":" << "{";
+        for (size_t i = 0; i < PHASE_AMOUNT; i++) {
+            s << "\"" << SOLVER_PHASE_NAMES[i] << "\"" << ":" << this->phaseNanoseconds[i];
+            if (i < PHASE_AMOUNT - 1) {
+                s << ",";
+            }
+        }
+        s << "}" << ",";
+        s << "\"nanoseconds\"" << ":" << this->totalNanoseconds() << ",";
+        s << "\"fights\"" << ":" << this->fights << ",";
+        s << "\"fightsPerSecond\"" << ":" << (int64_t) fightsPerSecond(this->fights, simulateNanoseconds) << ",";
+        s << "\"pureIn\"" << ":" << this->pureArmies << ",";
+        s << "\"heroIn\"" << ":" << this->heroArmies << ",";
+        s << "\"pureSurvivors\"" << ":" << this->pureSurvivors << ",";
+        s << "\"heroSurvivors\"" << ":" << this->heroSurvivors << ",";
+        s << "\"pureOut\"" << ":" << this->nextPureArmies << ",";
+        s << "\"heroOut\"" << ":" << this->nextHeroArmies << ",";
+        s << "\"frontierBytes\"" << ":" << this->frontierBytes << ",";
+        s << "\"residentBytes\"" << ":" << this->residentBytes;
+    s << "}";
+    return s.str();
+}
+
+string SolverMetrics::toJSON() const {
+    stringstream s;
+    s << "{";
+        s << "\"greedy\"" << ":" << this->greedyNanoseconds << ",";
+        s << "\"total\"" << ":" << this->totalNanoseconds << ",";
+        s << "\"memory\"" << ":" << "{";
+            s << "\"peakFrontierBytes\"" << ":" << this->peakFrontierBytes << ",";
+            s << "\"peakResidentBytes\"" << ":" << this->peakResidentBytes << ",";
+            s << "\"monsterDataBytes\"" << ":" << this->monsterDataBytes;
+        s << "}" << ",";
+        s << "\"levels\"" << ":" << "[";
+        for (size_t i = 0; i < this->levels.size(); i++) {
+            s << this->levels[i].toJSON();
+            if (i < this->levels.size() - 1) {
+                s << ",";
+            }
+        }
+        s << "]";
+        if (this->hardwareCountersUsed) {
+            s << "," << "\"hardware\"" << ":" << "{";
+            for (size_t i = 0; i < PHASE_AMOUNT; i++) {
+                s << "\"" << SOLVER_PHASE_NAMES[i] << "\"" << ":" << this->phaseHardware[i].toJSON(this->totalFights());
+                if (i < PHASE_AMOUNT - 1) {
+                    s << ",";
+                }
+            }
+            s << "}";
+        }
+    s << "}";
+    return s.str();
+}
+
+// Sample memory use for a level and keep the peaks. frontierBytes are the bytes of all army vectors alive at that point
+void SolverMetrics::recordMemory(LevelMetrics & level, size_t frontierBytes) {
+    size_t residentBytes = residentSetBytes();
+    level.frontierBytes = max(level.frontierBytes, frontierBytes);
+    level.residentBytes = max(level.residentBytes, residentBytes);
+    this->peakFrontierBytes = max(this->peakFrontierBytes, frontierBytes);
+    this->peakResidentBytes = max(this->peakResidentBytes, residentBytes);
+}
+
+size_t residentSetBytes() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmRSS:") == 0) {
+            return stoull(line.substr(6)) * 1024; // Reported in kB
+        }
+    }
+    return 0;
+}
+
+int64_t SolverMetrics::totalFights() const {
+    int64_t fights = 0;
+    for (size_t i = 0; i < this->levels.size(); i++) {
+        fights += this->levels[i].fights;
+    }
+    return fights;
+}
+
+// Table of the hardware counters per phase. Misses are divided by all fights of the solve to keep phases comparable
+string SolverMetrics::hardwareReport() const {
+    stringstream s;
+    if (!this->hardwareCountersUsed) {
+        s << "Hardware counters are not available on this machine." << endl;
+        return s.str();
+    }
+    int64_t fights = this->totalFights();
+    HardwareCounts total;
+    s << fixed << setprecision(2);
+    s << setw(15) << left << "Phase" << right << setw(16) << "Cycles" << setw(8) << "IPC" << setw(14) << "Cache/Fight" << setw(15) << "Branch/Fight" << endl;
+    for (size_t i = 0; i <= PHASE_AMOUNT; i++) {
+        const HardwareCounts & counts = (i < PHASE_AMOUNT) ? this->phaseHardware[i] : total;
+        s << setw(15) << left << (i < PHASE_AMOUNT ? SOLVER_PHASE_NAMES[i] : "total") << right;
+        s << setw(16) << counts.events[CYCLES_EVENT];
+        s << setw(8) << counts.instructionsPerCycle();
+        s << setw(14) << (fights > 0 ? (double) counts.events[CACHE_MISSES_EVENT] / (double) fights : 0);
+        s << setw(15) << (fights > 0 ? (double) counts.events[BRANCH_MISSES_EVENT] / (double) fights : 0) << endl;
+        if (i < PHASE_AMOUNT) {
+            total.add(counts);
+        }
+    }
+    return s.str();
+}
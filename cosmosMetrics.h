@@ -0,0 +1,80 @@
+#ifndef COSMOS_METRICS_HEADER
+#define COSMOS_METRICS_HEADER
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+
+#include "perfCounters.h"
+
+// Steps of one iteration of the solver loop. Their time is measured separately for every army size
+enum SolverPhase {
+    SIMULATE_PURE_PHASE,
+    SIMULATE_HERO_PHASE,
+    SORT_PHASE,
+    DOMINANCE_PURE_PHASE,
+    DOMINANCE_HERO_PHASE,
+    EXPAND_PHASE,
+    MOVE_PHASE,
+    PHASE_AMOUNT
+};
+const std::string SOLVER_PHASE_NAMES[PHASE_AMOUNT] {"simulatePure", "simulateHero", "sort", "dominancePure", "dominanceHero", "expand", "move"};
+
+// Timings and frontier sizes of one army size of the solver
+struct LevelMetrics {
+    size_t armySize;
+    int64_t phaseNanoseconds[PHASE_AMOUNT] = {};
+    int fights = 0;
+    size_t pureArmies = 0;      // Frontier sizes going into the level
+    size_t heroArmies = 0;
+    size_t pureSurvivors = 0;   // Armies that were not dominated
+    size_t heroSurvivors = 0;
+    size_t nextPureArmies = 0;  // Frontier sizes after expanding
+    size_t nextHeroArmies = 0;
+    size_t frontierBytes = 0;   // Most bytes held by army vectors during the level
+    size_t residentBytes = 0;   // Resident set size of the process at that point
+    
+    int64_t totalNanoseconds() const;
+    std::string toJSON() const;
+};
+
+// Timings of a whole solve
+struct SolverMetrics {
+    int64_t greedyNanoseconds = 0;  // Greedy upper bound and setup before the first level
+    int64_t totalNanoseconds = 0;
+    std::vector<LevelMetrics> levels;
+    size_t peakFrontierBytes = 0;   // Maxima of the levels
+    size_t peakResidentBytes = 0;
+    size_t monsterDataBytes = 0;    // monsterReference and monsterMap after the solve
+    bool hardwareCountersUsed = false;                  // Only set if requested and supported by the machine
+    HardwareCounts phaseHardware[PHASE_AMOUNT];         // Summed over all levels
+    
+    int64_t totalFights() const;
+    std::string toJSON() const;
+    std::string hardwareReport() const;
+    void recordMemory(LevelMetrics & level, size_t frontierBytes);
+};
+
+// Current resident set size of the process in bytes, 0 if the system does not tell (only read from /proc/self/status)
+size_t residentSetBytes();
+
+// Current time of a monotonic clock in nanoseconds
+inline int64_t monotonicNanoseconds() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Returns nanoseconds passed since lapStart and restarts the lap
+inline int64_t lapNanoseconds(int64_t & lapStart) {
+    int64_t now = monotonicNanoseconds();
+    int64_t elapsed = now - lapStart;
+    lapStart = now;
+    return elapsed;
+}
+
+// Fights per second for a number of fights simulated in the given nanoseconds
+inline double fightsPerSecond(int64_t fights, int64_t nanoseconds) {
+    return nanoseconds > 0 ? (double) fights * 1e9 / (double) nanoseconds : 0;
+}
+
+#endif
@@ -0,0 +1,305 @@
+#include "cosmosMultiTarget.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// A lineup together with its fight against every target. The fights are resumed target by target when the lineup grows
+struct MultiTargetArmy {
+    Army army;
+    FightResult results[MULTI_TARGET_MAX];
+    bool dominated = false;
+};
+
+static bool hasFewerMultiTargetFollowers(const MultiTargetArmy & a, const MultiTargetArmy & b) {
+    return a.army.followerCost < b.army.followerCost;
+}
+
+// Check if a is certainly not better than b against one target. A won fight beats every lost one
+static inline bool isWorseOn(const FightResult & a, const FightResult & b) {
+    if (!b.rightWon) {
+        return true;
+    }
+    return a.rightWon && a <= b;
+}
+
+// Check if a is certainly not better than b against every target
+static bool isWorseOnAll(const MultiTargetArmy & a, const MultiTargetArmy & b, size_t targetAmount) {
+    for (size_t k = 0; k < targetAmount; k++) {
+        if (!isWorseOn(a.results[k], b.results[k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Check if every hero of a is also in b
+static bool usesHeroSubset(const Army & a, const Army & b) {
+    for (int i = 0; i < a.monsterAmount; i++) {
+        if (monsterReference[a.monsters[i]].rarity != NO_HERO && find(b.monsters, b.monsters + b.monsterAmount, a.monsters[i]) == b.monsters + b.monsterAmount) {
+            return false;
+        }
+    }
+    return true;
+}
+
+string MultiTargetInstance::toString() {
+    stringstream s;
+
+    s << endl << "Solution for all of:" << endl;
+    for (size_t k = 0; k < this->targets.size(); k++) {
+        s << "  " << this->targets[k].toString() << endl;
+    }
+    if (!this->bestSolution.isEmpty()) {
+        s << "  " << this->bestSolution.toString() << endl;
+    } else {
+        s << endl << "Could not find a solution that beats all of these lineups." << endl;
+    }
+    s << "  " << this->totalFightsSimulated << " Fights simulated." << endl;
+    s << "  Total Calculation Time: " << this->calculationTime << endl << endl;
+    if (!this->bestSolution.isEmpty()) {
+        s << "Battle Replays (Use on Ingame Tournament Page):" << endl;
+        for (size_t k = 0; k < this->targets.size(); k++) {
+            s << makeBattleReplay(this->bestSolution, this->targets[k]) << endl;
+        }
+        s << endl;
+    }
+
+    return s.str();
+}
+
+string MultiTargetInstance::toJSON() {
+    stringstream s;
+    s << "{";
+        s << "\"targets\"" << ":" << "[";
+        for (size_t k = 0; k < this->targets.size(); k++) {
+            s << this->targets[k].toJSON() << (k + 1 < this->targets.size() ? "," : "");
+        }
+        s << "]" << ",";
+        s << "\"solution\"" << ":" << this->bestSolution.toJSON() << ",";
+        s << "\"time\"" << ":" << this->calculationTime << ",";
+        s << "\"fights\"" << ":" << this->totalFightsSimulated << ",";
+        s << "\"replays\"" << ":" << "[";
+        for (size_t k = 0; k < this->targets.size(); k++) {
+            s << "\"" << makeBattleReplay(this->bestSolution, this->targets[k]) << "\"" << (k + 1 < this->targets.size() ? "," : "");
+        }
+        s << "]";
+    s << "}";
+    return s.str();
+}
+
+MultiTargetInstance combineInstances(vector<Instance> & instances, int followerUpperBound) {
+    if (instances.size() > MULTI_TARGET_MAX) {
+        throw runtime_error("A lineup can only be solved against " + to_string(MULTI_TARGET_MAX) + " targets at once");
+    }
+    MultiTargetInstance combined;
+    combined.maxCombatants = ARMY_MAX_SIZE;
+    combined.followerUpperBound = followerUpperBound;
+    for (size_t i = 0; i < instances.size(); i++) {
+        combined.targets.push_back(instances[i].target);
+        combined.maxCombatants = min(combined.maxCombatants, instances[i].maxCombatants);
+    }
+    return combined;
+}
+
+// Fight a lineup against every target it hasn't beaten yet, the strongest targets first. The lineup is only loaded once for all of them.
+// A lineup that can't win against some target anymore is marked as dominated without fighting the others
+static void fightTargets(MultiTargetArmy & candidate, MultiTargetInstance & instance, const vector<ArmyCondition> & targetConditions,
+                         const vector<size_t> & order, const vector<bool> & optimizable, size_t armySize) {
+    ArmyCondition leftCondition = ArmyCondition();
+    leftCondition.init(candidate.army);
+    for (size_t i = 0; i < order.size(); i++) {
+        size_t k = order[i];
+        FightResult & result = candidate.results[k];
+        if (result.valid && !result.rightWon) {
+            continue; // Monsters added behind a winning lineup don't change the fight
+        }
+        simulateFight(leftCondition, targetConditions[k], result);
+        if (result.rightWon) {
+            // Same reasoning as the optimizable check of the single target solver
+            int targetSize = instance.targets[k].monsterAmount;
+            bool hopeless = armySize == instance.maxCombatants;
+            hopeless |= armySize + 1 == instance.maxCombatants && optimizable[k] && result.monstersLost < targetSize - 2 && result.rightAoeDamage == 0;
+            if (hopeless) {
+                candidate.dominated = true;
+                return;
+            }
+        }
+    }
+}
+
+static void fightAll(vector<MultiTargetArmy> & armies, MultiTargetInstance & instance, SolverContext & context, const vector<ArmyCondition> & targetConditions,
+                     const vector<size_t> & order, const vector<bool> & optimizable, size_t armySize) {
+    for (size_t i = 0; i < armies.size(); i++) {
+        fightTargets(armies[i], instance, targetConditions, order, optimizable, armySize);
+        if (armies[i].dominated || armies[i].army.followerCost >= instance.followerUpperBound) {
+            continue;
+        }
+        bool beatsAll = true;
+        for (size_t k = 0; k < instance.targets.size(); k++) {
+            beatsAll &= !armies[i].results[k].rightWon;
+        }
+        if (beatsAll) {
+            instance.followerUpperBound = armies[i].army.followerCost;
+            instance.bestSolution = armies[i].army;
+            context.io->outputMessage(instance.bestSolution.toString(), DETAILED_OUTPUT, 2);
+        }
+    }
+}
+
+// Same windows as markDominatedPureArmies and markDominatedHeroArmies, but a lineup has to be worse against every target
+static void markDominated(vector<MultiTargetArmy> & pureArmies, vector<MultiTargetArmy> & heroArmies, size_t targetAmount) {
+    size_t i, j;
+    for (i = 0; i < pureArmies.size(); i++) {
+        if (pureArmies[i].dominated) {
+            continue;
+        }
+        int followerCost = pureArmies[i].army.followerCost;
+        for (j = i+1; j < pureArmies.size() && pureArmies[j].army.followerCost <= followerCost; j++) {
+            if (isWorseOnAll(pureArmies[i], pureArmies[j], targetAmount)) {
+                pureArmies[i].dominated = true;
+                break;
+            }
+        }
+        for (j = 0; j < heroArmies.size() && heroArmies[j].army.followerCost >= followerCost; j++) {
+            if (isWorseOnAll(heroArmies[j], pureArmies[i], targetAmount)) {
+                heroArmies[j].dominated = true;
+            }
+        }
+    }
+    for (i = 0; i < heroArmies.size(); i++) {
+        if (heroArmies[i].dominated) {
+            continue;
+        }
+        int followerCost = heroArmies[i].army.followerCost;
+        for (j = i+1; j < heroArmies.size() && heroArmies[j].army.followerCost <= followerCost; j++) {
+            if (isWorseOnAll(heroArmies[i], heroArmies[j], targetAmount) && usesHeroSubset(heroArmies[j].army, heroArmies[i].army)) {
+                heroArmies[i].dominated = true;
+                break;
+            }
+        }
+    }
+}
+
+// Add a unit to the back of a lineup. resumable tells if the fights of the parent can be continued with it
+static void addChild(vector<MultiTargetArmy> & children, const MultiTargetArmy & parent, MonsterIndex unit, bool resumable, size_t targetAmount) {
+    children.push_back(parent);
+    children.back().army.add(unit);
+    for (size_t k = 0; k < targetAmount; k++) {
+        children.back().results[k].valid = resumable;
+    }
+}
+
+// Mirrors expand from solver.cpp
+static void expandAll(vector<MultiTargetArmy> & newPureArmies, vector<MultiTargetArmy> & newHeroArmies,
+                      vector<MultiTargetArmy> & oldPureArmies, vector<MultiTargetArmy> & oldHeroArmies,
+                      MultiTargetInstance & instance, SolverContext & context) {
+    size_t targetAmount = instance.targets.size();
+    SkillType skill;
+    for (size_t i = 0; i < oldPureArmies.size(); i++) {
+        if (oldPureArmies[i].dominated) {
+            continue;
+        }
+        int remainingFollowers = instance.followerUpperBound - oldPureArmies[i].army.followerCost;
+        for (size_t m = 0; m < context.availableMonsters.size() && monsterReference[context.availableMonsters[m]].cost < remainingFollowers; m++) {
+            addChild(newPureArmies, oldPureArmies[i], context.availableMonsters[m], true, targetAmount);
+        }
+        for (size_t m = 0; m < context.availableHeroes.size(); m++) {
+            skill = monsterReference[context.availableHeroes[m]].skill.type;
+            addChild(newHeroArmies, oldPureArmies[i], context.availableHeroes[m], skill == P_AOE || skill == FRIENDS || skill == BERSERK || skill == ADAPT, targetAmount);
+        }
+    }
+    for (size_t i = 0; i < oldHeroArmies.size(); i++) {
+        if (oldHeroArmies[i].dominated) {
+            continue;
+        }
+        const Army & parent = oldHeroArmies[i].army;
+        bool globalAbilityInfluence = false;
+        for (int j = 0; j < parent.monsterAmount; j++) {
+            skill = monsterReference[parent.monsters[j]].skill.type;
+            globalAbilityInfluence |= monsterReference[parent.monsters[j]].rarity != NO_HERO && (skill == FRIENDS || skill == RAINBOW);
+        }
+        int remainingFollowers = instance.followerUpperBound - parent.followerCost;
+        for (size_t m = 0; m < context.availableMonsters.size() && monsterReference[context.availableMonsters[m]].cost < remainingFollowers; m++) {
+            addChild(newHeroArmies, oldHeroArmies[i], context.availableMonsters[m], !globalAbilityInfluence, targetAmount);
+        }
+        for (size_t m = 0; m < context.availableHeroes.size(); m++) {
+            if (find(parent.monsters, parent.monsters + parent.monsterAmount, context.availableHeroes[m]) == parent.monsters + parent.monsterAmount) {
+                skill = monsterReference[context.availableHeroes[m]].skill.type;
+                addChild(newHeroArmies, oldHeroArmies[i], context.availableHeroes[m], skill == P_AOE || skill == FRIENDS || skill == BERSERK || skill == ADAPT, targetAmount);
+            }
+        }
+    }
+}
+
+void solveMultiTarget(MultiTargetInstance & instance, SolverContext & context) {
+    time_t startTime = time(NULL);
+    size_t targetAmount = instance.targets.size();
+    totalFightsSimulated = &instance.totalFightsSimulated;
+    instance.bestSolution = Army();
+
+    vector<ArmyCondition> targetConditions = loadConditions(instance.targets);
+
+    // Strong targets reject the most lineups, so they are fought first
+    vector<size_t> order;
+    for (size_t k = 0; k < targetAmount; k++) {
+        order.push_back(k);
+    }
+    sort(order.begin(), order.end(), [&](size_t a, size_t b) {return instance.targets[a].followerCost > instance.targets[b].followerCost;});
+
+    vector<MultiTargetArmy> pureArmies;
+    vector<MultiTargetArmy> heroArmies;
+    vector<Army> singlePure;
+    vector<Army> singleHeroes;
+    for (size_t i = 0; i < context.availableMonsters.size(); i++) {
+        if (monsterReference[context.availableMonsters[i]].cost <= instance.followerUpperBound) {
+            singlePure.push_back(Army({context.availableMonsters[i]}));
+            pureArmies.push_back(MultiTargetArmy());
+            pureArmies.back().army = singlePure.back();
+        }
+    }
+    for (size_t i = 0; i < context.availableHeroes.size(); i++) {
+        singleHeroes.push_back(Army({context.availableHeroes[i]}));
+        heroArmies.push_back(MultiTargetArmy());
+        heroArmies.back().army = singleHeroes.back();
+    }
+
+    // Check per target if single units can beat its last two monsters
+    vector<bool> optimizable;
+    for (size_t k = 0; k < targetAmount; k++) {
+        Instance single;
+        single.target = instance.targets[k];
+        single.targetSize = instance.targets[k].monsterAmount;
+        single.maxCombatants = instance.maxCombatants;
+        optimizable.push_back(isOptimizable(singlePure, singleHeroes, single));
+    }
+
+    for (size_t armySize = 1; armySize <= instance.maxCombatants; armySize++) {
+        context.io->outputMessage("Starting loop for armies of size " + to_string(armySize), BASIC_OUTPUT);
+        context.io->timedOutput("Simulating " + to_string(pureArmies.size()) + " non-hero lineups against " + to_string(targetAmount) + " targets... ", DETAILED_OUTPUT, 1, true);
+        fightAll(pureArmies, instance, context, targetConditions, order, optimizable, armySize);
+        context.io->timedOutput("Simulating " + to_string(heroArmies.size()) + " hero lineups against " + to_string(targetAmount) + " targets... ", DETAILED_OUTPUT, 1);
+        fightAll(heroArmies, instance, context, targetConditions, order, optimizable, armySize);
+
+        if (instance.bestSolution.monsterAmount > 0 && instance.bestSolution.followerCost == 0) {
+            break;
+        }
+        if (armySize < instance.maxCombatants) {
+            context.io->timedOutput("Sorting Lists... ", DETAILED_OUTPUT, 1);
+            sort(pureArmies.begin(), pureArmies.end(), hasFewerMultiTargetFollowers);
+            sort(heroArmies.begin(), heroArmies.end(), hasFewerMultiTargetFollowers);
+            if (context.firstDominance <= armySize) {
+                context.io->timedOutput("Calculating Dominance... ", DETAILED_OUTPUT, 1);
+                markDominated(pureArmies, heroArmies, targetAmount);
+            }
+            context.io->timedOutput("Expanding Lineups by one... ", DETAILED_OUTPUT, 1);
+            vector<MultiTargetArmy> nextPureArmies;
+            vector<MultiTargetArmy> nextHeroArmies;
+            expandAll(nextPureArmies, nextHeroArmies, pureArmies, heroArmies, instance, context);
+            pureArmies = move(nextPureArmies);
+            heroArmies = move(nextHeroArmies);
+        }
+        context.io->finishTimedOutput(DETAILED_OUTPUT);
+    }
+    instance.calculationTime = time(NULL) - startTime;
+}
@@ -0,0 +1,38 @@
+#ifndef COSMOS_MULTI_TARGET_HEADER
+#define COSMOS_MULTI_TARGET_HEADER
+
+#include <string>
+#include <vector>
+#include <ctime>
+
+#include "cosmosClasses.h"
+#include "inputProcessing.h"
+#include "solver.h"
+
+const std::string MULTI_TARGET_FLAG = "-multi-target";
+
+const size_t MULTI_TARGET_MAX = 8; // Most targets a single lineup can be solved against
+
+// Several enemy lineups that one lineup has to beat, e.g. the opponents of a tournament
+struct MultiTargetInstance {
+    std::vector<Army> targets;
+    size_t maxCombatants;   // Smallest limit of all targets
+
+    int followerUpperBound;
+    Army bestSolution;
+
+    time_t calculationTime;
+    int totalFightsSimulated = 0;
+
+    std::string toString();
+    std::string toJSON();
+};
+
+// Combine the instances of one input into a single multi target instance. Throws runtime_error if there are too many
+MultiTargetInstance combineInstances(std::vector<Instance> & instances, int followerUpperBound);
+
+// Find the cheapest lineup of the context's monsters and heroes that beats every target.
+// Every lineup keeps one fight result per target and is only dominated by lineups that are at least as good against all of them
+void solveMultiTarget(MultiTargetInstance & instance, SolverContext & context);
+
+#endif
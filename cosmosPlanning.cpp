@@ -0,0 +1,387 @@
+#include "cosmosPlanning.h"
+
+#include <algorithm>
+
+using namespace std;
+
+// Check if an army contains any level of a hero
+static bool containsHero(const Army & army, size_t baseHeroIndex) {
+    for (int i = 0; i < army.monsterAmount; i++) {
+        if (monsterReference[army.monsters[i]].rarity != NO_HERO && monsterReference[army.monsters[i]].baseName == baseHeroes[baseHeroIndex].baseName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+string HeroLevelResult::toString() {
+    stringstream s;
+
+    s << endl << "Hero level for " << this->target.toString() << ":" << endl;
+    if (this->level == 0) {
+        s << "  " << baseHeroes[this->baseHeroIndex].baseName << " can't beat this lineup at any level." << endl;
+    } else if (!containsHero(this->solution, this->baseHeroIndex)) {
+        s << "  " << baseHeroes[this->baseHeroIndex].baseName << " is not needed to beat this lineup." << endl;
+        s << "  " << this->solution.toString() << endl;
+    } else {
+        s << "  " << baseHeroes[this->baseHeroIndex].baseName << " needs level " << this->level << "." << endl;
+        s << "  " << this->solution.toString() << endl;
+    }
+    s << "  " << this->probes << " Levels probed, " << this->fights << " Fights simulated." << endl;
+
+    return s.str();
+}
+
+string HeroLevelResult::toJSON() {
+    stringstream s;
+    s << "{";
+        s << "\"target\"" << ":" << this->target.toJSON() << ",";
+        s << "\"hero\"" << ":" << "\"" << baseHeroes[this->baseHeroIndex].baseName << "\"" << ",";
+        s << "\"level\"" << ":" << this->level << ",";
+        s << "\"solution\"" << ":" << this->solution.toJSON() << ",";
+        s << "\"probes\"" << ":" << this->probes << ",";
+        s << "\"fights\"" << ":" << this->fights;
+    s << "}";
+    return s.str();
+}
+
+LevelPlanner::LevelPlanner(Instance & someInstance, SolverContext & someContext) :
+    instance(someInstance),
+    context(someContext)
+{
+    totalFightsSimulated = &this->instance.totalFightsSimulated;
+
+    vector<Army> pureArmies;
+    vector<Army> noArmies;
+    for (size_t i = 0; i < this->context.availableMonsters.size(); i++) {
+        pureArmies.push_back(Army({this->context.availableMonsters[i]}));
+    }
+    this->pureOptimizable = isOptimizable(pureArmies, noArmies, this->instance);
+}
+
+// Simulate the pure armies of the next size
+void LevelPlanner::addPureLevel() {
+    size_t armySize = this->pureLevels.size() + 1;
+    vector<Army> pureArmies;
+    vector<Army> noArmies;
+
+    if (armySize == 1) {
+        for (size_t i = 0; i < this->context.availableMonsters.size(); i++) {
+            if (monsterReference[this->context.availableMonsters[i]].cost <= this->instance.followerUpperBound) {
+                pureArmies.push_back(Army({this->context.availableMonsters[i]}));
+            }
+        }
+    } else {
+        SolverContext pureContext = this->context;
+        pureContext.availableHeroes.clear();
+        vector<Army> heroArmies;
+        expand(pureArmies, heroArmies, this->pureLevels.back(), noArmies, armySize - 1, this->instance, pureContext);
+    }
+
+    Army pureSolution;
+    for (size_t i = 0; i < pureArmies.size(); i++) {
+        simulateFight(pureArmies[i], this->instance.target);
+        if (!pureArmies[i].lastFightData.rightWon && pureArmies[i].followerCost < this->instance.followerUpperBound) {
+            if (pureSolution.isEmpty() || pureArmies[i].followerCost < pureSolution.followerCost) {
+                pureSolution = pureArmies[i];
+            }
+        }
+    }
+    this->pureSolutions.push_back(pureSolution);
+
+    // Optimizable pruning depends on the heroes of a probe, so pure armies are never pruned by it
+    sort(pureArmies.begin(), pureArmies.end(), hasFewerFollowers);
+    if (this->context.firstDominance <= armySize) {
+        markDominatedPureArmies(pureArmies, noArmies, armySize, this->instance, this->context.constraints, false);
+    }
+    this->pureLevels.push_back(move(pureArmies));
+}
+
+// Fight an army with the probed hero at its probe level. Armies without it can resume their last fight as usual
+void LevelPlanner::simulateProbe(Army & army, Army & target, const HeroProbe & heroProbe) {
+    vector<LevelOverride> overrides;
+    for (int i = 0; i < army.monsterAmount && heroProbe.level > 0; i++) {
+        if (army.monsters[i] == heroProbe.hero) {
+            overrides.push_back({i, heroProbe.level, heroProbe.stats});
+        }
+    }
+    if (overrides.empty()) {
+        simulateFight(army, target);
+    } else {
+        simulateFight(army, target, overrides);
+    }
+}
+
+// Look for lineups of the context's monsters and the given heroes that beat the instance for less than upperBound followers.
+// Stops at the first one if firstOnly is set, otherwise finds the cheapest like solveInstance would. Returns false if there is none
+bool LevelPlanner::search(const vector<MonsterIndex> & heroes, const HeroProbe & heroProbe, int upperBound, bool firstOnly, Army & solution) {
+    SolverContext searchContext = this->context;
+    searchContext.availableHeroes = heroes;
+    Instance bounded = this->instance; // expand and dominance read the bound from the instance
+    bounded.followerUpperBound = min(upperBound, this->instance.followerUpperBound);
+    bool found = false;
+
+    vector<Army> heroArmies;
+    vector<Army> otherHeroArmies;
+    vector<Army> noArmies;
+    for (size_t i = 0; i < heroes.size(); i++) {
+        heroArmies.push_back(Army({heroes[i]}));
+        if (heroes[i] != heroProbe.hero || heroProbe.level == 0) {
+            otherHeroArmies.push_back(heroArmies.back());
+        }
+    }
+    bool optimizable = this->pureOptimizable && isOptimizable(noArmies, otherHeroArmies, bounded);
+    if (optimizable && otherHeroArmies.size() < heroArmies.size()) { // Same check as isOptimizable for the probed hero
+        Army lastTwo({bounded.target.monsters[bounded.targetSize - 2], bounded.target.monsters[bounded.targetSize - 1]});
+        Army probed({heroProbe.hero});
+        this->simulateProbe(probed, lastTwo, heroProbe);
+        optimizable = probed.lastFightData.rightWon;
+    }
+
+    for (size_t armySize = 1; armySize <= bounded.maxCombatants; armySize++) {
+        if (this->pureLevels.size() < armySize) {
+            this->addPureLevel();
+        }
+        Army & pureSolution = this->pureSolutions[armySize - 1];
+        if (!pureSolution.isEmpty() && pureSolution.followerCost < bounded.followerUpperBound) {
+            solution = pureSolution;
+            bounded.followerUpperBound = solution.followerCost;
+            found = true;
+            if (firstOnly) {
+                return true;
+            }
+        }
+
+        for (size_t i = 0; i < heroArmies.size(); i++) {
+            this->simulateProbe(heroArmies[i], bounded.target, heroProbe);
+            if (!heroArmies[i].lastFightData.rightWon && heroArmies[i].followerCost < bounded.followerUpperBound) {
+                solution = heroArmies[i];
+                bounded.followerUpperBound = solution.followerCost;
+                found = true;
+                if (firstOnly) {
+                    return true;
+                }
+            }
+        }
+        if (armySize == bounded.maxCombatants || (found && solution.followerCost == 0)) {
+            break;
+        }
+
+        vector<Army> & pureArmies = this->pureLevels[armySize - 1];
+        sort(heroArmies.begin(), heroArmies.end(), hasFewerFollowers);
+        if (this->context.firstDominance <= armySize) {
+            markDominatedPureArmies(pureArmies, heroArmies, armySize, bounded, searchContext.constraints, false, 1, false); // Only marks hero armies, the pure ones are already done
+            markDominatedHeroArmies(heroArmies, armySize, bounded, searchContext.constraints, optimizable);
+        }
+        vector<Army> nextPureArmies;
+        vector<Army> nextHeroArmies;
+        expand(nextPureArmies, nextHeroArmies, pureArmies, heroArmies, armySize, bounded, searchContext, false);
+        heroArmies = move(nextHeroArmies);
+    }
+    return found;
+}
+
+// Check if a lineup of the context's monsters and the given heroes beats the instance. The first one found is written into solution
+bool LevelPlanner::probe(const vector<MonsterIndex> & heroes, const HeroProbe & heroProbe, Army & solution) {
+    return this->search(heroes, heroProbe, this->instance.followerUpperBound, true, solution);
+}
+
+// Find the cheapest lineup of the context's monsters and the given heroes that costs less than upperBound followers
+bool LevelPlanner::solve(const vector<MonsterIndex> & heroes, const HeroProbe & heroProbe, int upperBound, Army & solution) {
+    return this->search(heroes, heroProbe, upperBound, false, solution);
+}
+
+// Roster of the context with a stand-in for the hero that heroProbe lets fight at the given level
+vector<MonsterIndex> LevelPlanner::rosterWithLevel(size_t baseHeroIndex, int level, int standInLevel, HeroProbe & heroProbe) {
+    vector<MonsterIndex> heroes = this->context.availableHeroes;
+    heroProbe.level = level;
+    heroProbe.stats = leveledHeroStats(baseHeroIndex, level);
+    for (size_t i = 0; i < heroes.size(); i++) {
+        if (monsterReference[heroes[i]].baseName == baseHeroes[baseHeroIndex].baseName) {
+            heroProbe.hero = heroes[i];
+            return heroes;
+        }
+    }
+    heroProbe.hero = addLeveledHero(baseHeroIndex, standInLevel);
+    heroes.push_back(heroProbe.hero);
+    return heroes;
+}
+
+// Binary search the lowest level of a hero at which the roster wins. The other heroes keep their levels
+HeroLevelResult LevelPlanner::findMinimumLevel(size_t baseHeroIndex, int minLevel, int maxLevel) {
+    HeroLevelResult result;
+    result.target = this->instance.target;
+    result.followerUpperBound = this->instance.followerUpperBound;
+    result.baseHeroIndex = baseHeroIndex;
+    int fightsBefore = this->instance.totalFightsSimulated;
+    Army solution;
+    HeroProbe heroProbe;
+    vector<MonsterIndex> roster = this->rosterWithLevel(baseHeroIndex, maxLevel, maxLevel, heroProbe);
+
+    result.probes++;
+    if (this->probe(roster, heroProbe, solution)) {
+        // Invariant: result.level wins, everything below lowLevel loses
+        int lowLevel = minLevel;
+        result.level = maxLevel;
+        result.solution = solution;
+        while (lowLevel < result.level) {
+            int level = lowLevel + (result.level - lowLevel) / 2;
+            result.probes++;
+            heroProbe.level = level;
+            heroProbe.stats = leveledHeroStats(baseHeroIndex, level);
+            if (this->probe(roster, heroProbe, solution)) {
+                result.level = level;
+                result.solution = solution;
+            } else {
+                lowLevel = level + 1;
+            }
+        }
+    }
+    // The solution holds the stand-in, only the level that was found becomes a real hero
+    if (containsHero(result.solution, baseHeroIndex) && monsterReference[heroProbe.hero].level != result.level) {
+        MonsterIndex leveledHero = addLeveledHero(baseHeroIndex, result.level);
+        Army leveled;
+        for (int i = 0; i < result.solution.monsterAmount; i++) {
+            leveled.add(result.solution.monsters[i] == heroProbe.hero ? leveledHero : result.solution.monsters[i]);
+        }
+        leveled.lastFightData = result.solution.lastFightData;
+        result.solution = leveled;
+    }
+    result.fights = this->instance.totalFightsSimulated - fightsBefore;
+    return result;
+}
+
+// Best follower costs when the hero gains the levels of LEVEL_SWEEP_STEPS. Every step is bounded by the one before
+LevelSweepResult LevelPlanner::sweepHero(MonsterIndex hero) {
+    LevelSweepResult result;
+    result.hero = hero;
+    result.baseCost = this->instance.followerUpperBound;
+    size_t baseHeroIndex = (size_t) heroMap.at(monsterReference[hero].baseName);
+    int bound = result.baseCost;
+    Army solution;
+    HeroProbe heroProbe;
+
+    for (size_t i = 0; i < LEVEL_SWEEP_STEP_AMOUNT; i++) {
+        int level = min(monsterReference[hero].level + LEVEL_SWEEP_STEPS[i], HERO_TABLE_MAX_LEVEL);
+        vector<MonsterIndex> roster = this->rosterWithLevel(baseHeroIndex, level, level, heroProbe); // The hero is in the roster, so nothing is added
+        if (bound > 0 && this->solve(roster, heroProbe, bound, solution)) {
+            bound = solution.followerCost;
+        }
+        result.followerCosts[i] = bound; // Leveling never hurts, so the best lineup of the last step still wins
+    }
+    return result;
+}
+
+string LevelSweepResult::toJSON() {
+    stringstream s;
+    s << "{";
+        s << "\"hero\"" << ":" << monsterReference[this->hero].toJSON() << ",";
+        s << "\"followers\"" << ":" << "[";
+        for (size_t i = 0; i < LEVEL_SWEEP_STEP_AMOUNT; i++) {
+            s << this->followerCosts[i] << (i + 1 < LEVEL_SWEEP_STEP_AMOUNT ? "," : "");
+        }
+        s << "]";
+    s << "}";
+    return s.str();
+}
+
+// Solve an instance, then find its best follower costs with every hero of the roster leveled up.
+// Returns nothing if the instance can't be beaten with the current levels
+vector<LevelSweepResult> sweepHeroLevels(Instance & instance, SolverContext & context) {
+    vector<LevelSweepResult> results;
+    solveInstance(instance, context);
+    if (instance.bestSolution.isEmpty() || instance.bestSolution.followerCost > instance.followerUpperBound) {
+        return results;
+    }
+
+    // The solver leaves its best cost as upper bound, which limits the pure armies of the planner and bounds every leveled solve
+    LevelPlanner planner(instance, context);
+    for (size_t i = 0; i < context.availableHeroes.size(); i++) {
+        results.push_back(planner.sweepHero(context.availableHeroes[i]));
+    }
+    return results;
+}
+
+string levelSweepToString(Instance & instance, vector<LevelSweepResult> & results) {
+    stringstream s;
+    s << endl << "Hero levels for " << instance.target.toString() << ":" << endl;
+    if (results.empty()) {
+        s << "  Could not find a solution to compare with." << endl;
+        return s.str();
+    }
+    s << "  " << instance.bestSolution.toString() << endl;
+    for (size_t i = 0; i < results.size(); i++) {
+        s << "  " << left << setw(24) << monsterReference[results[i].hero].name << right;
+        for (size_t j = 0; j < LEVEL_SWEEP_STEP_AMOUNT; j++) {
+            s << " +" << setw(2) << left << LEVEL_SWEEP_STEPS[j] << right << ": " << setw(8) << results[i].followerCosts[j];
+        }
+        s << endl;
+    }
+    return s.str();
+}
+
+string levelSweepToJSON(Instance & instance, vector<LevelSweepResult> & results) {
+    stringstream s;
+    s << "{";
+        s << "\"target\"" << ":" << instance.target.toJSON() << ",";
+        s << "\"solution\"" << ":" << (results.empty() ? "null" : instance.bestSolution.toJSON()) << ",";
+        s << "\"fights\"" << ":" << instance.totalFightsSimulated << ",";
+        s << "\"sweep\"" << ":" << "[";
+        for (size_t i = 0; i < results.size(); i++) {
+            s << results[i].toJSON() << (i + 1 < results.size() ? "," : "");
+        }
+        s << "]";
+    s << "}";
+    return s.str();
+}
+
+// Add the followers every step saved on an instance
+void LevelSweepTotals::add(vector<LevelSweepResult> & results) {
+    if (results.empty()) {
+        return;
+    }
+    this->instances++;
+    for (size_t i = 0; i < results.size(); i++) {
+        size_t hero = 0;
+        while (hero < this->heroes.size() && this->heroes[hero] != results[i].hero) {
+            hero++;
+        }
+        if (hero == this->heroes.size()) {
+            this->heroes.push_back(results[i].hero);
+            this->savings.push_back({});
+        }
+        for (size_t j = 0; j < LEVEL_SWEEP_STEP_AMOUNT; j++) {
+            this->savings[hero][j] += results[i].baseCost - results[i].followerCosts[j];
+        }
+    }
+}
+
+string LevelSweepTotals::toString() {
+    stringstream s;
+    s << endl << "Followers saved over " << this->instances << " lineups:" << endl;
+    for (size_t i = 0; i < this->heroes.size(); i++) {
+        s << "  " << left << setw(24) << monsterReference[this->heroes[i]].name << right;
+        for (size_t j = 0; j < LEVEL_SWEEP_STEP_AMOUNT; j++) {
+            s << " +" << setw(2) << left << LEVEL_SWEEP_STEPS[j] << right << ": " << setw(10) << this->savings[i][j];
+        }
+        s << endl;
+    }
+    return s.str();
+}
+
+string LevelSweepTotals::toJSON() {
+    stringstream s;
+    s << "{";
+        s << "\"instances\"" << ":" << this->instances << ",";
+        s << "\"saved\"" << ":" << "[";
+        for (size_t i = 0; i < this->heroes.size(); i++) {
+            s << "{" << "\"hero\"" << ":" << monsterReference[this->heroes[i]].toJSON() << "," << "\"followers\"" << ":" << "[";
+            for (size_t j = 0; j < LEVEL_SWEEP_STEP_AMOUNT; j++) {
+                s << this->savings[i][j] << (j + 1 < LEVEL_SWEEP_STEP_AMOUNT ? "," : "");
+            }
+            s << "]" << "}" << (i + 1 < this->heroes.size() ? "," : "");
+        }
+        s << "]";
+    s << "}";
+    return s.str();
+}
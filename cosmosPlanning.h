@@ -0,0 +1,104 @@
+#ifndef COSMOS_PLANNING_HEADER
+#define COSMOS_PLANNING_HEADER
+
+#include <string>
+#include <vector>
+#include <array>
+
+#include "cosmosClasses.h"
+#include "cosmosDefines.h"
+#include "inputProcessing.h"
+#include "solver.h"
+#include "battleLogic.h"
+
+const std::string MIN_LEVEL_FLAG = "-min-level";
+const std::string LEVEL_SWEEP_FLAG = "-level-sweep";
+
+const size_t LEVEL_SWEEP_STEP_AMOUNT = 3;
+const int LEVEL_SWEEP_STEPS[LEVEL_SWEEP_STEP_AMOUNT] {1, 5, 10}; // Levels a hero gains in a level sweep
+
+// Lowest level of a hero at which some lineup beats an instance, see LevelPlanner::findMinimumLevel
+struct HeroLevelResult {
+    Army target;
+    int followerUpperBound;
+    size_t baseHeroIndex;
+    int level = 0;          // 0 if the hero can't win even at the highest level searched
+    Army solution;          // First winning lineup found at that level. Doesn't need to contain the hero
+    int probes = 0;
+    int fights = 0;
+
+    std::string toString();
+    std::string toJSON();
+};
+
+// Best follower costs of an instance when one hero of the roster gains levels, see LevelPlanner::sweepHero
+struct LevelSweepResult {
+    MonsterIndex hero;      // The hero at its level in the roster
+    int baseCost;           // Cost of the best solution with the roster as it is
+    int followerCosts[LEVEL_SWEEP_STEP_AMOUNT]; // Cost of the best solution after every step of LEVEL_SWEEP_STEPS
+
+    std::string toJSON();
+};
+
+// Followers that leveling every hero saves summed over several instances
+struct LevelSweepTotals {
+    std::vector<MonsterIndex> heroes;
+    std::vector<std::array<int64_t, LEVEL_SWEEP_STEP_AMOUNT>> savings;
+    size_t instances = 0;
+
+    void add(std::vector<LevelSweepResult> & results);
+    std::string toString();
+    std::string toJSON();
+};
+
+// A hero of the roster that fights at another level. Its stats come from heroStatTable, so probing a level doesn't add it to monsterReference
+struct HeroProbe {
+    MonsterIndex hero = 0;  // Stand-in for the hero in the roster, any level of it
+    int level = 0;          // 0 if the stand-in fights at its own level
+    HeroStats stats;
+};
+
+// Answers questions about hero levels for one instance within its followerUpperBound.
+// Pure monster armies don't depend on hero levels, so they are simulated once and shared by all probes and solves
+class LevelPlanner {
+    private:
+        Instance & instance;
+        SolverContext & context;
+        std::vector<std::vector<Army>> pureLevels; // Simulated pure armies of every size built so far, sorted and marked for dominance
+        std::vector<Army> pureSolutions;            // Cheapest winning pure army of every size, empty if there is none
+        bool pureOptimizable;                       // No single monster beats the last two monsters of the target
+
+        void addPureLevel();
+        bool search(const std::vector<MonsterIndex> & heroes, const HeroProbe & heroProbe, int upperBound, bool firstOnly, Army & solution);
+        void simulateProbe(Army & army, Army & target, const HeroProbe & heroProbe);
+
+    public:
+        LevelPlanner(Instance & instance, SolverContext & context);
+
+        // Check if a lineup of the context's monsters and the given heroes beats the instance. The first one found is written into solution
+        bool probe(const std::vector<MonsterIndex> & heroes, const HeroProbe & heroProbe, Army & solution);
+
+        // Find the cheapest lineup of the context's monsters and the given heroes that costs less than upperBound followers
+        bool solve(const std::vector<MonsterIndex> & heroes, const HeroProbe & heroProbe, int upperBound, Army & solution);
+
+        // Roster of the context with a stand-in for the hero that heroProbe lets fight at the given level.
+        // The roster's own level of the hero is the stand-in, otherwise standInLevel of it is added to monsterReference once
+        std::vector<MonsterIndex> rosterWithLevel(size_t baseHeroIndex, int level, int standInLevel, HeroProbe & heroProbe);
+
+        // Binary search the lowest level of a hero at which the roster wins. The other heroes keep their levels.
+        // Assumes that leveling a hero never loses a fight that was won before. The probed levels are not added to monsterReference, only the level found
+        // and, if the hero is not in the roster, its stand-in at maxLevel. The solver reads skill and rarity of heroes from there, so it needs one entry
+        HeroLevelResult findMinimumLevel(size_t baseHeroIndex, int minLevel = 1, int maxLevel = HERO_TABLE_MAX_LEVEL);
+
+        // Best follower costs when a hero of the roster gains the levels of LEVEL_SWEEP_STEPS.
+        // The instance's upper bound must be the cost of its best solution, it bounds the first step and every step bounds the next
+        LevelSweepResult sweepHero(MonsterIndex hero);
+};
+
+// Solve an instance, then find its best follower costs with every hero of the roster leveled up.
+// All leveled solves share one planner and none of them adds a leveled hero to monsterReference. Returns nothing if the instance can't be beaten with the current levels
+std::vector<LevelSweepResult> sweepHeroLevels(Instance & instance, SolverContext & context);
+std::string levelSweepToString(Instance & instance, std::vector<LevelSweepResult> & results);
+std::string levelSweepToJSON(Instance & instance, std::vector<LevelSweepResult> & results);
+
+#endif
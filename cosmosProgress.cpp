@@ -0,0 +1,62 @@
+#include "cosmosProgress.h"
+
+#include <sstream>
+
+using namespace std;
+
+ProgressStream::ProgressStream(const string & fileName) :
+    file(fileName, ios::out | ios::app)
+{}
+
+bool ProgressStream::isOpen() const {
+    return this->file.is_open();
+}
+
+// Every event is a single line that names the event and the nanoseconds since the current instance started
+void ProgressStream::writeEvent(const string & event, const string & fields) {
+    lock_guard<mutex> lock(this->fileMutex);
+    this->file << "{";
+        this->file << "\"event\"" << ":" << "\"" << event << "\"" << ",";
+        this->file << "\"elapsed\"" << ":" << monotonicNanoseconds() - this->instanceStart;
+        if (!fields.empty()) {
+            this->file << "," << fields;
+        }
+    this->file << "}" << endl;
+}
+
+void ProgressStream::instanceStarted(Instance & instance) {
+    this->instanceStart = monotonicNanoseconds();
+    stringstream s;
+    s << "\"target\"" << ":" << instance.target.toJSON() << ",";
+    s << "\"maxCombatants\"" << ":" << instance.maxCombatants;
+    this->writeEvent("instanceStarted", s.str());
+}
+
+void ProgressStream::levelStarted(size_t armySize, size_t pureArmies, size_t heroArmies, size_t remainingLevels, double estimatedFights) {
+    stringstream s;
+    s << "\"armySize\"" << ":" << armySize << ",";
+    s << "\"pureArmies\"" << ":" << pureArmies << ",";
+    s << "\"heroArmies\"" << ":" << heroArmies << ",";
+    s << "\"remainingLevels\"" << ":" << remainingLevels << ",";
+    s << "\"estimatedFights\"" << ":" << (int64_t) estimatedFights;
+    this->writeEvent("levelStarted", s.str());
+}
+
+void ProgressStream::phaseFinished(size_t armySize, const string & phase, int64_t nanoseconds) {
+    stringstream s;
+    s << "\"armySize\"" << ":" << armySize << ",";
+    s << "\"phase\"" << ":" << "\"" << phase << "\"" << ",";
+    s << "\"nanoseconds\"" << ":" << nanoseconds;
+    this->writeEvent("phaseFinished", s.str());
+}
+
+void ProgressStream::newIncumbent(Army & solution) {
+    this->writeEvent("newIncumbent", "\"followers\":" + to_string(solution.followerCost) + ",\"solution\":" + solution.toJSON());
+}
+
+void ProgressStream::instanceFinished(Instance & instance) {
+    stringstream s;
+    s << "\"fights\"" << ":" << instance.totalFightsSimulated << ",";
+    s << "\"solution\"" << ":" << instance.bestSolution.toJSON();
+    this->writeEvent("instanceFinished", s.str());
+}
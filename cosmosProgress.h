@@ -0,0 +1,35 @@
+#ifndef COSMOS_PROGRESS_HEADER
+#define COSMOS_PROGRESS_HEADER
+
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+#include "inputProcessing.h"
+
+const std::string PROGRESS_FLAG = "-progress";
+
+// Writes the progress of the solver as one json object per line to a file or file descriptor (e.g. /dev/fd/3).
+// Front ends can follow it to show live progress while stdout only contains the normal output.
+class ProgressStream {
+    private:
+        std::ofstream file;
+        std::mutex fileMutex;
+        int64_t instanceStart = 0;
+
+        void writeEvent(const std::string & event, const std::string & fields);
+
+    public:
+        ProgressStream(const std::string & fileName);
+
+        bool isOpen() const;
+        void instanceStarted(Instance & instance);
+        // pendingFights is the frontier of this level, estimatedFights extrapolates it over the remaining levels
+        void levelStarted(size_t armySize, size_t pureArmies, size_t heroArmies, size_t remainingLevels, double estimatedFights);
+        void phaseFinished(size_t armySize, const std::string & phase, int64_t nanoseconds);
+        void newIncumbent(Army & solution);
+        void instanceFinished(Instance & instance);
+};
+
+#endif
@@ -0,0 +1,208 @@
+#include "cosmosTournament.h"
+
+#include <algorithm>
+#include <atomic>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+// Winning lineups of one line, cheapest first, and the roster heroes every one of them uses
+struct LineCandidates {
+    vector<Army> lineups;
+    vector<vector<size_t>> heroes; // Indices into the roster of the context
+};
+
+// One solve that contributes candidates to a line: the cheapest lineups with the whole roster, or the cheapest one with a single hero or none
+struct CandidateSolve {
+    size_t line;
+    Instance instance;
+    vector<MonsterIndex> heroes;
+    size_t solutionAmount;
+};
+
+// Run the candidate solves in parallel. Every line needs one solve per roster hero on top of the full one,
+// so workers take the next solve of any line instead of one line each and a hard line doesn't keep the others waiting.
+// The context is copied per solve, prints nothing and answers the solver's questions with their defaults
+static void runCandidateSolves(vector<CandidateSolve> & solves, const SolverContext & context) {
+    atomic<size_t> next(0);
+    auto work = [&]() {
+        for (size_t i = next++; i < solves.size(); i = next++) {
+            IOManager quiet;
+            quiet.outputLevel = SOLUTION_OUTPUT;
+            SolverContext solveContext = context;
+            solveContext.io = &quiet;
+            solveContext.trace = nullptr;
+            solveContext.progress = nullptr;
+            solveContext.onProgress = nullptr;
+            solveContext.onNewSolution = nullptr;
+            solveContext.perfCounters = false;
+            solveContext.paretoCriteria = NO_PARETO;
+            solveContext.availableHeroes = solves[i].heroes;
+            solveContext.solutionAmount = solves[i].solutionAmount;
+            solveInstance(solves[i].instance, solveContext);
+        }
+    };
+    size_t threadAmount = min((size_t) max(1u, thread::hardware_concurrency()), solves.size());
+    vector<thread> workers;
+    for (size_t i = 0; i < threadAmount; i++) {
+        workers.push_back(thread(work));
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+}
+
+// Collect the winning lineups of a line's solves once, cheapest first, with the roster heroes they use
+static void collectCandidates(const vector<Army> & found, const vector<MonsterIndex> & roster, LineCandidates & candidates) {
+    vector<Army> sorted = found;
+    sort(sorted.begin(), sorted.end(), hasFewerFollowers);
+    set<vector<MonsterIndex>> seen;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        if (!seen.insert(vector<MonsterIndex>(sorted[i].monsters, sorted[i].monsters + sorted[i].monsterAmount)).second) {
+            continue; // Found by more than one solve
+        }
+        candidates.lineups.push_back(sorted[i]);
+        candidates.heroes.push_back({});
+        for (int j = 0; j < sorted[i].monsterAmount; j++) {
+            auto hero = find(roster.begin(), roster.end(), sorted[i].monsters[j]);
+            if (hero != roster.end()) {
+                candidates.heroes.back().push_back(hero - roster.begin());
+            }
+        }
+    }
+}
+
+// Branch and bound over one candidate or none per line with every roster hero used at most once
+static void assignLines(size_t line, const vector<LineCandidates> & candidates, vector<bool> & usedHeroes, vector<int> & choice,
+                        int wins, int followers, vector<int> & bestChoice, int & bestWins, int & bestFollowers) {
+    int remaining = (int) (candidates.size() - line);
+    if (wins + remaining < bestWins || (wins + remaining == bestWins && followers >= bestFollowers)) {
+        return;
+    }
+    if (remaining == 0) {
+        bestChoice = choice;
+        bestWins = wins;
+        bestFollowers = followers;
+        return;
+    }
+    const LineCandidates & options = candidates[line];
+    for (size_t i = 0; i < options.lineups.size(); i++) {
+        bool free = true;
+        for (size_t h = 0; h < options.heroes[i].size(); h++) {
+            free &= !usedHeroes[options.heroes[i][h]];
+        }
+        if (!free) {
+            continue;
+        }
+        for (size_t h = 0; h < options.heroes[i].size(); h++) {
+            usedHeroes[options.heroes[i][h]] = true;
+        }
+        choice[line] = (int) i;
+        assignLines(line + 1, candidates, usedHeroes, choice, wins + 1, followers + options.lineups[i].followerCost, bestChoice, bestWins, bestFollowers);
+        for (size_t h = 0; h < options.heroes[i].size(); h++) {
+            usedHeroes[options.heroes[i][h]] = false;
+        }
+    }
+    choice[line] = -1; // Give the line up
+    assignLines(line + 1, candidates, usedHeroes, choice, wins, followers, bestChoice, bestWins, bestFollowers);
+}
+
+TournamentResult solveTournament(vector<Instance> & lines, SolverContext & context) {
+    if (lines.size() > TOURNAMENT_LINES) {
+        throw runtime_error("A tournament has at most " + to_string(TOURNAMENT_LINES) + " lines");
+    }
+    time_t startTime = time(NULL);
+    TournamentResult result;
+
+    // The cheapest lineups usually share the strongest heroes, the ones with a single hero or none leave heroes for the remaining lines.
+    // The solves only share the read only monster data, so they run in parallel
+    const vector<MonsterIndex> & roster = context.availableHeroes;
+    vector<CandidateSolve> solves;
+    for (size_t i = 0; i < lines.size(); i++) {
+        solves.push_back({i, lines[i], roster, TOURNAMENT_CANDIDATES});
+        for (size_t h = 0; h <= roster.size(); h++) {
+            solves.push_back({i, lines[i], h < roster.size() ? vector<MonsterIndex> {roster[h]} : vector<MonsterIndex> {}, 1});
+        }
+    }
+    runCandidateSolves(solves, context);
+
+    // Every line's full solve comes before its restricted ones, which only add their fights
+    vector<LineCandidates> candidates(lines.size());
+    vector<vector<Army>> found(lines.size());
+    for (size_t i = 0; i < solves.size(); i++) {
+        Instance & solved = solves[i].instance;
+        if (solves[i].solutionAmount > 1) {
+            lines[solves[i].line] = solved;
+            found[solves[i].line].insert(found[solves[i].line].end(), solved.solutions.begin(), solved.solutions.end());
+            if (solved.solutions.empty() && !solved.bestSolution.isEmpty()) {
+                found[solves[i].line].push_back(solved.bestSolution);
+            }
+        } else {
+            lines[solves[i].line].totalFightsSimulated += solved.totalFightsSimulated;
+            if (!solved.bestSolution.isEmpty()) {
+                found[solves[i].line].push_back(solved.bestSolution);
+            }
+        }
+    }
+    for (size_t i = 0; i < lines.size(); i++) {
+        collectCandidates(found[i], roster, candidates[i]);
+    }
+
+    vector<bool> usedHeroes(context.availableHeroes.size(), false);
+    vector<int> choice(lines.size(), -1);
+    vector<int> bestChoice(lines.size(), -1);
+    int bestWins = -1;
+    int bestFollowers = 0;
+    assignLines(0, candidates, usedHeroes, choice, 0, 0, bestChoice, bestWins, bestFollowers);
+
+    for (size_t i = 0; i < lines.size(); i++) {
+        result.lines.push_back(lines[i].target);
+        result.lineups.push_back(bestChoice[i] >= 0 ? candidates[i].lineups[bestChoice[i]] : Army());
+        result.totalFightsSimulated += lines[i].totalFightsSimulated;
+    }
+    result.linesWon = bestWins;
+    result.totalFollowers = bestFollowers;
+    result.calculationTime = time(NULL) - startTime;
+    return result;
+}
+
+string TournamentResult::toString() {
+    stringstream s;
+
+    s << endl << "Tournament:" << endl;
+    for (size_t i = 0; i < this->lines.size(); i++) {
+        s << "  Line " << i + 1 << ": " << this->lines[i].toString() << endl;
+        if (!this->lineups[i].isEmpty()) {
+            s << "    " << this->lineups[i].toString() << endl;
+        } else {
+            s << "    Given up" << endl;
+        }
+    }
+    s << "  " << this->linesWon << " of " << this->lines.size() << " lines won with " << this->totalFollowers << " followers." << endl;
+    s << "  " << this->totalFightsSimulated << " Fights simulated." << endl;
+    s << "  Total Calculation Time: " << this->calculationTime << endl << endl;
+    s << "Battle Replay (Use on Ingame Tournament Page):" << endl << makeTournamentReplay(this->lineups, this->lines) << endl << endl;
+
+    return s.str();
+}
+
+string TournamentResult::toJSON() {
+    stringstream s;
+    s << "{";
+        s << "\"lines\"" << ":" << "[";
+        for (size_t i = 0; i < this->lines.size(); i++) {
+            s << "{";
+                s << "\"target\"" << ":" << this->lines[i].toJSON() << ",";
+                s << "\"solution\"" << ":" << this->lineups[i].toJSON();
+            s << "}" << (i + 1 < this->lines.size() ? "," : "");
+        }
+        s << "]" << ",";
+        s << "\"won\"" << ":" << this->linesWon << ",";
+        s << "\"followers\"" << ":" << this->totalFollowers << ",";
+        s << "\"fights\"" << ":" << this->totalFightsSimulated << ",";
+        s << "\"time\"" << ":" << this->calculationTime << ",";
+        s << "\"replay\"" << ":" << "\"" << makeTournamentReplay(this->lineups, this->lines) << "\"";
+    s << "}";
+    return s.str();
+}
@@ -0,0 +1,33 @@
+#ifndef COSMOS_TOURNAMENT_HEADER
+#define COSMOS_TOURNAMENT_HEADER
+
+#include <string>
+#include <vector>
+#include <ctime>
+
+#include "cosmosClasses.h"
+#include "inputProcessing.h"
+#include "solver.h"
+
+const std::string TOURNAMENT_FLAG = "-tournament";
+
+const size_t TOURNAMENT_CANDIDATES = 20; // Cheapest lineups of every line that take part in the assignment
+
+// Lineups for all lines of a tournament in which every hero fights in at most one line
+struct TournamentResult {
+    std::vector<Army> lines;        // Opponent lineups
+    std::vector<Army> lineups;      // Lineup assigned to every line, empty if the line is given up
+    int linesWon = 0;
+    int totalFollowers = 0;
+    int totalFightsSimulated = 0;
+    time_t calculationTime;
+
+    std::string toString();
+    std::string toJSON();
+};
+
+// Solve every line for its cheapest lineups and the cheapest ones with a single hero or none, all solves spread over the cores, then pick one lineup per line
+// so that no hero is used twice. Most lines won comes first, then fewest followers. Throws runtime_error for more than TOURNAMENT_LINES lines
+TournamentResult solveTournament(std::vector<Instance> & lines, SolverContext & context);
+
+#endif
@@ -0,0 +1,95 @@
+#include "cosmosTrace.h"
+
+#include <sstream>
+#include <iomanip>
+#include <atomic>
+
+#include "inputProcessing.h"
+
+using namespace std;
+
+static atomic<int> nextTrack(1);
+static thread_local int threadTrack = 0;
+
+TraceWriter::TraceWriter(const string & fileName) :
+    file(fileName, ios::out | ios::trunc)
+{
+    this->origin = monotonicNanoseconds();
+    this->file << "[";
+    this->writeEvent("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"CosmosQuest\"}}");
+}
+
+TraceWriter::~TraceWriter() {
+    this->file << "]" << endl;
+}
+
+bool TraceWriter::isOpen() const {
+    return this->file.is_open();
+}
+
+// Tracks are numbered in the order threads first write to any trace
+int TraceWriter::currentTrack() {
+    if (threadTrack == 0) {
+        threadTrack = nextTrack++;
+        this->writeEvent("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + to_string(threadTrack) + ",\"args\":{\"name\":\"solver thread " + to_string(threadTrack) + "\"}}");
+    }
+    return threadTrack;
+}
+
+void TraceWriter::writeEvent(const string & event) {
+    lock_guard<mutex> lock(this->fileMutex);
+    this->file << (this->firstEvent ? "" : ",\n") << event;
+    this->firstEvent = false;
+    this->file.flush();
+}
+
+// Chrome traces count in microseconds
+static string traceTime(int64_t nanoseconds) {
+    stringstream s;
+    s << fixed << setprecision(3) << (double) nanoseconds / 1000.0;
+    return s.str();
+}
+
+void TraceWriter::span(const string & name, const string & category, int64_t start, int64_t end, const string & args) {
+    int track = this->currentTrack();
+    stringstream s;
+    s << "{";
+        s << "\"name\"" << ":" << "\"" << escapeJSON(name) << "\"" << ",";
+        s << "\"cat\"" << ":" << "\"" << category << "\"" << ",";
+        s << "\"ph\"" << ":" << "\"X\"" << ",";
+        s << "\"pid\"" << ":" << 1 << ",";
+        s << "\"tid\"" << ":" << track << ",";
+        s << "\"ts\"" << ":" << traceTime(start - this->origin) << ",";
+        s << "\"dur\"" << ":" << traceTime(end - start);
+        if (!args.empty()) {
+            s << "," << "\"args\"" << ":" << args;
+        }
+    s << "}";
+    this->writeEvent(s.str());
+}
+
+void TraceWriter::counter(const string & name, const string & values) {
+    stringstream s;
+    s << "{";
+        s << "\"name\"" << ":" << "\"" << escapeJSON(name) << "\"" << ",";
+        s << "\"ph\"" << ":" << "\"C\"" << ",";
+        s << "\"pid\"" << ":" << 1 << ",";
+        s << "\"ts\"" << ":" << traceTime(monotonicNanoseconds() - this->origin) << ",";
+        s << "\"args\"" << ":" << values;
+    s << "}";
+    this->writeEvent(s.str());
+}
+
+TraceScope::TraceScope(TraceWriter * someTrace, const string & someName, const string & someCategory) :
+    trace(someTrace),
+    name(someName),
+    category(someCategory)
+{
+    this->start = monotonicNanoseconds();
+}
+
+TraceScope::~TraceScope() {
+    if (this->trace) {
+        this->trace->span(this->name, this->category, this->start, monotonicNanoseconds(), this->args);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef COSMOS_TRACE_HEADER
+#define COSMOS_TRACE_HEADER
+
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <cstdint>
+
+const std::string TRACE_FLAG = "-trace";
+
+// Writes spans and counters of solver runs as a Chrome trace event file (open it in chrome://tracing or Perfetto).
+// Events are streamed as a json array that the viewers also accept when it is cut off, so a stalled or killed run still shows where it was.
+// Events can be added from any thread; every thread gets its own track.
+class TraceWriter {
+    private:
+        std::ofstream file;
+        std::mutex fileMutex;
+        int64_t origin;
+        bool firstEvent = true;
+
+        void writeEvent(const std::string & event);
+        int currentTrack();
+
+    public:
+        TraceWriter(const std::string & fileName);
+        ~TraceWriter();
+        TraceWriter(const TraceWriter &) = delete;
+        TraceWriter & operator=(const TraceWriter &) = delete;
+
+        bool isOpen() const;
+        // A span on the track of the calling thread. Times are monotonicNanoseconds, args is a json object or empty
+        void span(const std::string & name, const std::string & category, int64_t start, int64_t end, const std::string & args = "");
+        // Values of a counter track at the current time, values is a json object of numbers
+        void counter(const std::string & name, const std::string & values);
+};
+
+// Adds a span from its construction to its destruction to the trace, if there is one
+class TraceScope {
+    private:
+        TraceWriter * trace;
+        std::string name;
+        std::string category;
+        int64_t start;
+
+    public:
+        std::string args; // Json object shown with the span, may be filled in while the scope runs
+
+        TraceScope(TraceWriter * someTrace, const std::string & someName, const std::string & someCategory);
+        ~TraceScope();
+};
+
+#endif
@@ -0,0 +1,183 @@
+#include "cosmosVerify.h"
+
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "cosmosClasses.h"
+#include "inputProcessing.h"
+#include "battleLogic.h"
+
+using namespace std;
+
+// Load a lineup string like makeInstanceFromString would, but heroes take their stats from heroStatTable
+// instead of being added to monsterReference, so any amount of hero levels can be verified. Throws for malformed lineups
+static void loadLineup(const string & lineup, ArmyCondition & condition) {
+    if (lineup.compare(0, QUEST_PREFIX.length(), QUEST_PREFIX) == 0) {
+        condition.init(makeInstanceFromString(lineup).target);
+        return;
+    }
+    vector<string> units = split(lineup, ELEMENT_SEPARATOR);
+    if (units.size() > ARMY_MAX_SIZE) {
+        throw invalid_argument("Too many units in " + lineup);
+    }
+    for (size_t i = 0; i < units.size(); i++) {
+        if (units[i].find(HEROLEVEL_SEPARATOR()) != units[i].npos) {
+            pair<size_t, int> hero = parseHeroString(units[i]);
+            condition.setMonster((int) i, baseHeroes[hero.first]);
+            condition.setLevel((int) i, hero.second, leveledHeroStats(hero.first, hero.second));
+        } else {
+            condition.setMonster((int) i, monsterReference[monsterMap.at(units[i])]);
+        }
+    }
+    condition.armySize = (int) units.size();
+}
+
+// Parses every distinct lineup once and keeps it loaded for fighting
+class LineupTable {
+    private:
+        unordered_map<string, int> ids;
+
+    public:
+        vector<ArmyCondition> conditions;
+
+        // Index into conditions or -1 if the lineup is malformed
+        int intern(const string & lineup) {
+            auto known = this->ids.find(lineup);
+            if (known != this->ids.end()) {
+                return known->second;
+            }
+            int id = -1;
+            try {
+                ArmyCondition condition = ArmyCondition();
+                loadLineup(lineup, condition);
+                if (condition.armySize > 0) {
+                    id = (int) this->conditions.size();
+                    this->conditions.push_back(condition);
+                }
+            } catch (const exception & e) {}
+            this->ids[lineup] = id;
+            return id;
+        }
+
+        // Load a lineup of a replay, heroes take their stats from heroStatTable like in loadLineup
+        int add(const vector<ReplayUnit> & units) {
+            if (units.empty() || units.size() > ARMY_MAX_SIZE) {
+                return -1;
+            }
+            ArmyCondition condition = ArmyCondition();
+            for (size_t i = 0; i < units.size(); i++) {
+                if (units[i].hero >= 0) {
+                    condition.setMonster((int) i, baseHeroes[units[i].hero]);
+                    condition.setLevel((int) i, units[i].level, leveledHeroStats(units[i].hero, units[i].level));
+                } else {
+                    condition.setMonster((int) i, monsterReference[units[i].monster]);
+                }
+            }
+            condition.armySize = (int) units.size();
+            this->conditions.push_back(condition);
+            return (int) this->conditions.size() - 1;
+        }
+
+        size_t size() const {
+            return this->conditions.size();
+        }
+
+        void clear() {
+            this->ids.clear();
+            this->conditions.clear();
+        }
+};
+
+// Fight the pairs from start on in steps of stride, so that every thread gets an even share of long and short fights
+static void fightPairs(const vector<ArmyCondition> & conditions, const vector<pair<int, int>> & pairs, vector<FightResult> & results, size_t start, size_t stride) {
+    int fights = 0;
+    totalFightsSimulated = &fights;
+    for (size_t i = start; i < pairs.size(); i += stride) {
+        if (pairs[i].first >= 0 && pairs[i].second >= 0) {
+            simulateFight(conditions[pairs[i].first], conditions[pairs[i].second], results[i]);
+        }
+    }
+}
+
+VerifySummary verifyLineups(istream & input, ostream & output) {
+    time_t startTime = time(NULL);
+    VerifySummary summary;
+    LineupTable lineups;
+    size_t threadAmount = max(1u, thread::hardware_concurrency());
+    vector<pair<int, int>> pairs;
+    vector<FightResult> results;
+    string line;
+
+    while (input) {
+        if (lineups.size() > VERIFY_INTERN_LIMIT) {
+            lineups.clear();
+        }
+        pairs.clear();
+        while (pairs.size() < VERIFY_CHUNK && getline(input, line)) {
+            istringstream tokens(line);
+            string left, right, rest;
+            if (!(tokens >> left)) {
+                continue; // Empty line
+            }
+            if (!(tokens >> right) && isReplayString(left)) {
+                try {
+                    ReplayLineups replay = decodeBattleReplay(left, false);
+                    pairs.push_back({lineups.add(replay.friendlyUnits.at(0)), lineups.add(replay.hostileUnits.at(0))});
+                } catch (const exception & e) {
+                    pairs.push_back({-1, -1});
+                }
+                continue;
+            }
+            if (right.empty() || (tokens >> rest)) {
+                pairs.push_back({-1, -1});
+                continue;
+            }
+            pairs.push_back({lineups.intern(toLower(left)), lineups.intern(toLower(right))});
+        }
+
+        results.assign(pairs.size(), FightResult());
+        vector<thread> workers;
+        for (size_t t = 0; t < threadAmount && t < pairs.size(); t++) {
+            workers.push_back(thread(fightPairs, cref(lineups.conditions), cref(pairs), ref(results), t, threadAmount));
+        }
+        for (size_t t = 0; t < workers.size(); t++) {
+            workers[t].join();
+        }
+
+        stringstream s;
+        for (size_t i = 0; i < pairs.size(); i++) {
+            summary.pairs++;
+            if (pairs[i].first < 0 || pairs[i].second < 0) {
+                summary.errors++;
+                s << "E\n";
+                continue;
+            }
+            const FightResult & result = results[i];
+            char outcome = 'W';
+            if (result.rightWon && result.monstersLost >= lineups.conditions[pairs[i].second].armySize) {
+                outcome = 'D';
+                summary.draws++;
+            } else if (result.rightWon) {
+                outcome = 'L';
+                summary.rightWins++;
+            } else {
+                summary.leftWins++;
+            }
+            s << outcome << " " << (int) result.monstersLost << " " << result.damage << " " << (int) result.turncounter;
+            s << " " << result.leftAoeDamage << " " << result.rightAoeDamage << " " << (int) result.berserk << "\n";
+        }
+        output << s.str();
+    }
+    output.flush();
+    summary.calculationTime = time(NULL) - startTime;
+    return summary;
+}
+
+string VerifySummary::toString() {
+    stringstream s;
+    s << this->pairs << " Pairs verified: " << this->leftWins << " won, " << this->rightWins << " lost, " << this->draws << " draws, " << this->errors << " malformed." << endl;
+    s << "Total Calculation Time: " << this->calculationTime << endl;
+    return s.str();
+}
@@ -0,0 +1,33 @@
+#ifndef COSMOS_VERIFY_HEADER
+#define COSMOS_VERIFY_HEADER
+
+#include <string>
+#include <iostream>
+#include <ctime>
+
+const std::string VERIFY_FLAG = "-verify";
+const std::string VERIFY_OUTPUT_FLAG = "-verify-output";
+
+const size_t VERIFY_CHUNK = 1 << 18;            // Pairs read from the file before they are fought
+const size_t VERIFY_INTERN_LIMIT = 1 << 20;     // Parsed lineups kept between chunks, the table is cleared when it grows beyond this
+
+// Counts of a batch verification
+struct VerifySummary {
+    size_t pairs = 0;
+    size_t leftWins = 0;
+    size_t rightWins = 0;
+    size_t draws = 0;
+    size_t errors = 0;      // Lines that could not be parsed
+    time_t calculationTime;
+
+    std::string toString();
+};
+
+// Fight every "ourLineup enemyLineup" line of input, or the first line of a replay string, and write one result line per pair to output:
+//   W|L|D monstersLost damage turns leftAoeDamage rightAoeDamage berserk   (left won, right won, both sides died), the FightResult at the end
+//   E                                                                      (the line could not be parsed)
+// Lineups are written like lineup input and may be quests. Every distinct lineup is parsed once, heroes are not added to monsterReference.
+// The fights of a chunk run in parallel
+VerifySummary verifyLineups(std::istream & input, std::ostream & output);
+
+#endif
@@ -8,6 +8,7 @@ const size_t FINISH_MESSAGE_LENGTH = 20;
 IOManager::IOManager() {
     this->useMacroFile = false;
     this->showQueries = true;
+    this->macroInput = &this->macroFile;
     this->outputLevel = BASIC_OUTPUT;
     
     this->lastTimedOutput = -1;
@@ -20,6 +21,7 @@ bool IOManager::shouldOutput(OutputLevel urgency) {
 // Initialize a macro file provided by filename
 void IOManager::initMacroFile(string macroFileName, bool showInput) {
     this->macroFile.open(macroFileName);
+    this->macroInput = &this->macroFile;
     
     this->useMacroFile = this->macroFile.good();
     this->showQueries = this->macroFile.good() && showInput;
@@ -28,6 +30,17 @@ void IOManager::initMacroFile(string macroFileName, bool showInput) {
     }
 }
 
+// Use a string as macro file. Used by the server to feed requests into the normal input flow
+void IOManager::initMacroString(string macroContent, bool showInput) {
+    this->macroString.str(macroContent);
+    this->macroString.clear();
+    this->macroInput = &this->macroString;
+    
+    this->useMacroFile = true;
+    this->showQueries = showInput;
+    this->interactive = false;
+}
+
 // Output method called only by class. takes an output level to determine if it should be printed or not
 void IOManager::printBuffer(OutputLevel urgency) {
     if (this->shouldOutput(urgency)) {
@@ -56,14 +69,16 @@ void IOManager::timedOutput(string message, OutputLevel urgency, int indent, boo
     if (this->lastTimedOutput >= 0 && !reset) {
         this->finishTimedOutput(urgency);
     }
-    lastTimedOutput = time(NULL);
+    lastTimedOutput = monotonicNanoseconds();
     this->outputStream << left << setw(STANDARD_CMD_WIDTH - FINISH_MESSAGE_LENGTH) << this->getIndent(indent) + message;
     this->printBuffer(urgency);
 }
 
 // Finish the final timed message without adding another
 void IOManager::finishTimedOutput(OutputLevel urgency) {
-    this->outputStream << "Done! (" << right << setw(3) << time(NULL) - this->lastTimedOutput << " seconds)" << endl; // Exactly 20 characters long
+    double seconds = (double) (monotonicNanoseconds() - this->lastTimedOutput) / 1e9;
+    this->outputStream << "Done! (" << right << fixed << setprecision(3) << setw(8) << seconds << " sec)" << endl; // Exactly 20 characters long
+    this->outputStream.unsetf(ios::floatfield);
     this->printBuffer(urgency);
 }
 
@@ -94,19 +109,29 @@ string IOManager::getResistantInput(string query, string help, QueryType queryTy
     while (true) {
         // Check first if there is still a line in the macro file
         if (this->useMacroFile) {
-            this->useMacroFile = (bool) getline(this->macroFile, inputString);
+            this->useMacroFile = (bool) getline(*this->macroInput, inputString);
         } 
+        // The end of a macro string is the end of all input. Answer no and leave text empty, only numbers can't be made up
+        if (!this->useMacroFile && !this->interactive) {
+            if (queryType == question) {
+                return NEGATIVE_ANSWER;
+            }
+            if (queryType == raw || queryType == rawFirst) {
+                return "";
+            }
+            throw runtime_error("Input ended unexpectedly.");
+        }
         // Print the query only if no macro file is used or specifically asked for
         if (!this->useMacroFile || this->showQueries) {
             cout << query;
         }
         // Ask for user input
-        if (!this->useMacroFile) {
-            getline(cin, inputString);
+        if (!this->useMacroFile && !getline(cin, inputString)) {
+            throw runtime_error("Input ended unexpectedly.");
         }
         
         // Process Input
-        inputString = split(toLower(inputString), COMMENT_DELIMITOR)[0]; // trim potential comments in a macrofile and convert to lowercase
+        inputString = normalizeInput(inputString); // trim potential comments in a macrofile and convert to lowercase
         firstToken = split(inputString, TOKEN_SEPARATOR)[0]; // except for rare input only the first string till a space is used
         if (this->useMacroFile && this->showQueries) {
             cout << inputString << endl; // Show input if a macro file is used
@@ -152,10 +177,10 @@ bool IOManager::askYesNoQuestion(string questionMessage, string help, OutputLeve
 }
 
 // Promt the User via command line to input his hero levels and return a vector of their indices
-vector<int8_t> IOManager::takeHerolevelInput() {
-    vector<int8_t> heroes {};
+vector<MonsterIndex> IOManager::takeHerolevelInput() {
+    vector<MonsterIndex> heroes {};
     string input;
-    pair<Monster, int> heroData;
+    pair<size_t, int> heroData;
     
     if (!this->useMacroFile || this->showQueries) {
         cout << endl << "Enter your Heroes with levels. Press enter after every Hero." << endl;
@@ -171,6 +196,8 @@ vector<int8_t> IOManager::takeHerolevelInput() {
             try {
                 heroData = parseHeroString(input);
                 heroes.push_back(addLeveledHero(heroData.first, heroData.second));
+            } catch (const length_error & e) {
+                this->outputMessage(e.what(), VITAL_OUTPUT); // The hero is valid, but there is no room for it
             } catch (const exception & e) {};
         }
     } while (input != "done" && cancelCounter < 2);
@@ -188,12 +215,26 @@ vector<Instance> IOManager::takeInstanceInput(string prompt) {
     while (true) {
         input = this->getResistantInput(prompt, lineupInputHelp, raw);
         instances.clear();
+        if (!this->useMacroFile && !this->interactive) {
+            return instances; // No more input, nothing to solve
+        }
         instanceStrings = split(input, TOKEN_SEPARATOR);
         try {
             for (size_t i = 0; i < instanceStrings.size(); i++) {
-                instances.push_back(makeInstanceFromString(instanceStrings[i]));
+                if (isReplayString(instanceStrings[i])) {
+                    vector<Army> lines = decodeBattleReplay(instanceStrings[i]).hostile;
+                    for (size_t j = 0; j < lines.size(); j++) {
+                        if (j == 0 || lines[j].toString() != lines[j-1].toString()) { // Replays of a single fight repeat it on every line
+                            instances.push_back(makeInstanceFromArmy(lines[j]));
+                        }
+                    }
+                } else {
+                    instances.push_back(makeInstanceFromString(instanceStrings[i]));
+                }
             }
             return instances;
+        } catch (const length_error & e) {
+            this->outputMessage(e.what(), VITAL_OUTPUT);
         } catch (const exception & e) {}
     }
 }
@@ -205,7 +246,10 @@ Instance makeInstanceFromString(string instanceString) {
     
     if (instanceString.compare(0, QUEST_PREFIX.length(), QUEST_PREFIX) == 0) {
         int questNumber = stoi(instanceString.substr(QUEST_PREFIX.length(), dashPosition-QUEST_PREFIX.length()));
-        instance.target = makeArmyFromStrings(quests[questNumber]);
+        if (questNumber < 0 || (size_t) questNumber >= questLineups.size() || questLineups[questNumber].empty()) {
+            throw out_of_range("Quest Not Found");
+        }
+        instance.target = Army(questLineups[questNumber]);
         instance.maxCombatants = ARMY_MAX_SIZE - (stoi(instanceString.substr(dashPosition+1, 1)) - 1);
     } else {
         vector<string> stringLineup = split(instanceString, ELEMENT_SEPARATOR);
@@ -216,10 +260,19 @@ Instance makeInstanceFromString(string instanceString) {
     return instance;
 }
 
+// Make an instance to solve with all slots available from a lineup
+Instance makeInstanceFromArmy(const Army & army) {
+    Instance instance;
+    instance.target = army;
+    instance.maxCombatants = ARMY_MAX_SIZE;
+    instance.targetSize = instance.target.monsterAmount;
+    return instance;
+}
+
 // Parse string linup input into actual monsters. If there are heroes in the input, a leveled hero is added to the database
 Army makeArmyFromStrings(vector<string> stringMonsters) {
     Army army;
-    pair<Monster, int> heroData;
+    pair<size_t, int> heroData;
     
     for(size_t i = 0; i < stringMonsters.size(); i++) {
         if(stringMonsters[i].find(HEROLEVEL_SEPARATOR()) != stringMonsters[i].npos) {
@@ -232,22 +285,145 @@ Army makeArmyFromStrings(vector<string> stringMonsters) {
     return army;
 }
 
-// Parse hero input from a string into its name and level
-pair<Monster, int> parseHeroString(string heroString) {
-    string name = heroString.substr(0, heroString.find(HEROLEVEL_SEPARATOR()));
-    int level = stoi(heroString.substr(heroString.find(HEROLEVEL_SEPARATOR())+1));
+// Parse hero input from a string into its index in baseHeroes and its level
+pair<size_t, int> parseHeroString(const string & heroString) {
+    size_t separatorPosition = heroString.find(HEROLEVEL_SEPARATOR());
+    int level = stoi(heroString.substr(separatorPosition+1));
     
-	Monster hero;
-	for (size_t i = 0; i < baseHeroes.size(); i++) {
-		if (baseHeroes[i].baseName == name) {
-            return pair<Monster, int>(baseHeroes[i], level);
-		}
-	}
-    throw out_of_range("Hero Name Not Found");
+    auto hero = heroMap.find(heroString.substr(0, separatorPosition));
+    if (hero == heroMap.end()) {
+        throw out_of_range("Hero Name Not Found");
+    }
+    return pair<size_t, int>(hero->second, level);
+}
+
+// Read the integers of the array stored under key in the json of a replay
+static vector<int> getReplayArray(const string & json, const string & key) {
+    size_t start = json.find("\"" + key + "\"");
+    size_t end = json.npos;
+    if (start != json.npos) {
+        start = json.find("[", start);
+        end = json.find("]", start);
+    }
+    if (end == json.npos) {
+        throw invalid_argument("Replay has no " + key);
+    }
+    vector<int> values;
+    vector<string> numbers = split(json.substr(start + 1, end - start - 1), ELEMENT_SEPARATOR);
+    for (size_t i = 0; i < numbers.size(); i++) {
+        if (!numbers[i].empty()) {
+            values.push_back(stoi(numbers[i]));
+        }
+    }
+    return values;
+}
+
+// Turn the ingame indices of one side of a replay back into the units of every line, the reverse of getReplaySetup and getReplayHeroes
+static vector<vector<ReplayUnit>> getReplayLines(const vector<int> & setup, const vector<int> & heroLevels) {
+    unordered_map<int, MonsterIndex> monsters;
+    for (auto monster = monsterReplayMap.begin(); monster != monsterReplayMap.end(); monster++) {
+        auto index = monsterMap.find(monster->first);
+        if (index != monsterMap.end()) {
+            monsters[monster->second] = index->second;
+        }
+    }
+    
+    vector<vector<ReplayUnit>> lines;
+    for (size_t line = 0; line * ARMY_MAX_SIZE < setup.size(); line++) {
+        vector<ReplayUnit> lineup;
+        for (size_t i = line * ARMY_MAX_SIZE; i < setup.size() && i < (line + 1) * ARMY_MAX_SIZE; i++) {
+            if (setup[i] == REPLAY_EMPTY_SPOT) {
+                continue;
+            }
+            ReplayUnit unit;
+            if (setup[i] < 0) {
+                size_t hero = (size_t) (-setup[i] - 2);
+                if (hero >= baseHeroes.size() || hero >= heroLevels.size() || heroLevels[hero] < 1) {
+                    throw invalid_argument("Replay has an unknown hero");
+                }
+                unit.hero = (int) hero;
+                unit.level = heroLevels[hero];
+            } else {
+                auto monster = monsters.find(setup[i]);
+                if (monster == monsters.end()) {
+                    throw invalid_argument("Replay has an unknown monster");
+                }
+                unit.monster = monster->second;
+            }
+            lineup.push_back(unit);
+        }
+        reverse(lineup.begin(), lineup.end()); // Replays start with the last monster of a lineup
+        if (!lineup.empty()) {
+            lines.push_back(lineup);
+        }
+    }
+    return lines;
+}
+
+// Make armies of replay lines, heroes are added to the database
+static vector<Army> makeReplayArmies(const vector<vector<ReplayUnit>> & lines) {
+    vector<Army> armies;
+    for (size_t line = 0; line < lines.size(); line++) {
+        vector<MonsterIndex> lineup;
+        for (size_t i = 0; i < lines[line].size(); i++) {
+            const ReplayUnit & unit = lines[line][i];
+            lineup.push_back(unit.hero >= 0 ? addLeveledHero(unit.hero, unit.level) : unit.monster);
+        }
+        armies.push_back(Army(lineup));
+    }
+    return armies;
+}
+
+ReplayLineups decodeBattleReplay(string replay, bool addHeroes) {
+    if (isReplayString(replay)) {
+        replay = replay.substr(REPLAY_PREFIX.length());
+    }
+    vector<BYTE> decoded = base64_decode(replay);
+    string json(decoded.begin(), decoded.end());
+    
+    ReplayLineups lineups;
+    lineups.friendlyUnits = getReplayLines(getReplayArray(json, "setup"), getReplayArray(json, "shero"));
+    lineups.hostileUnits = getReplayLines(getReplayArray(json, "player"), getReplayArray(json, "phero"));
+    if (addHeroes) {
+        lineups.friendly = makeReplayArmies(lineups.friendlyUnits);
+        lineups.hostile = makeReplayArmies(lineups.hostileUnits);
+    }
+    return lineups;
+}
+
+bool isReplayString(const string & input) {
+    return toLower(input.substr(0, REPLAY_PREFIX.length())) == REPLAY_PREFIX;
+}
+
+string normalizeInput(const string & input) {
+    if (toLower(input).find(REPLAY_PREFIX) == input.npos) {
+        return split(toLower(input), COMMENT_DELIMITOR)[0];
+    }
+    // A replay may contain the comment delimitor, so comments are only looked for outside of them
+    string normalized;
+    vector<string> tokens = split(input, TOKEN_SEPARATOR);
+    for (size_t i = 0; i < tokens.size(); i++) {
+        normalized += (i > 0 ? TOKEN_SEPARATOR : "");
+        if (isReplayString(tokens[i])) {
+            normalized += REPLAY_PREFIX + tokens[i].substr(REPLAY_PREFIX.length());
+            continue;
+        }
+        size_t comment = tokens[i].find(COMMENT_DELIMITOR);
+        normalized += toLower(tokens[i].substr(0, comment));
+        if (comment != tokens[i].npos) {
+            break;
+        }
+    }
+    return normalized;
 }
 
 // Create valid string to be used ingame to view the battle between armies friendly and hostile
 string makeBattleReplay(Army friendly, Army hostile) {
+    return makeTournamentReplay(vector<Army>(TOURNAMENT_LINES, friendly), vector<Army>(TOURNAMENT_LINES, hostile));
+}
+
+// Create valid string to be used ingame to view the battles of a whole tournament, one army per line
+string makeTournamentReplay(vector<Army> friendly, vector<Army> hostile) {
     stringstream replay;
     replay << "{";
         replay << "\"winner\""  << ":" << "\"Unknown\"" << ",";
@@ -266,10 +442,16 @@ string makeBattleReplay(Army friendly, Army hostile) {
 
 // Get lineup in ingame indices
 string getReplaySetup(Army setup) {
+    return getReplaySetup(vector<Army>(TOURNAMENT_LINES, setup));
+}
+
+// Get lineups of all tournament lines in ingame indices. Missing lines stay empty
+string getReplaySetup(vector<Army> lines) {
     stringstream stringSetup;
     size_t i;
     stringSetup << "[";
     for (i = 0; i < ARMY_MAX_SIZE * TOURNAMENT_LINES; i++) {
+        Army setup = i / ARMY_MAX_SIZE < lines.size() ? lines[i / ARMY_MAX_SIZE] : Army();
         if ((int) (i % ARMY_MAX_SIZE) < setup.monsterAmount) {
             stringSetup << getReplayMonsterNumber(monsterReference[setup.monsters[setup.monsterAmount - (i % ARMY_MAX_SIZE) - 1]]);
         } else {
@@ -286,18 +468,15 @@ string getReplaySetup(Army setup) {
 // Get ingame index of monster. 0 and Positive for monsters and -1 to negative for heroes
 string getReplayMonsterNumber(Monster monster) {
     int8_t index = REPLAY_EMPTY_SPOT;
-    size_t i;
     if(monster.rarity != NO_HERO) {
-        for (i = 0; i < baseHeroes.size(); i++) {
-            if (baseHeroes[i].baseName == monster.baseName) {
-                index = (int8_t) (-i - 2);
-            }
+        auto hero = heroMap.find(monster.baseName);
+        if (hero != heroMap.end()) {
+            index = (int8_t) (-hero->second - 2);
         }
     } else {
-        for (i = 0; i < monsterBaseList.size(); i++) {
-            if (monster.name == monsterBaseList[i].name) {
-                index = (int8_t) i;
-            }
+        auto replayNumber = monsterReplayMap.find(monster.name);
+        if (replayNumber != monsterReplayMap.end()) {
+            index = replayNumber->second;
         }
     }
     return to_string(index);
@@ -305,21 +484,25 @@ string getReplayMonsterNumber(Monster monster) {
 
 // Get list of relevant herolevels in ingame format
 string getReplayHeroes(Army setup) {
+    return getReplayHeroes(vector<Army>(1, setup));
+}
+
+// Get list of herolevels of all tournament lines in ingame format
+string getReplayHeroes(vector<Army> lines) {
     stringstream heroes;
-    Monster monster;
-    int level;
-    heroes << "[";
-    for (size_t i = 0; i < baseHeroes.size(); i++) {
-        level = 0;
-        for (int j = 0; j < setup.monsterAmount; j++) {
-            monster = monsterReference[setup.monsters[j]];
-            if (monster.rarity != NO_HERO && monster.baseName == baseHeroes[i].baseName) {
-                level = monster.level;
-                break;
+    vector<int> levels(baseHeroes.size(), 0);
+    for (int i = (int) lines.size() - 1; i >= 0; i--) {
+        for (int j = lines[i].monsterAmount - 1; j >= 0; j--) { // Backwards so the first occurrence of a hero wins
+            const Monster & monster = monsterReference[lines[i].monsters[j]];
+            if (monster.rarity != NO_HERO) {
+                levels[heroMap.at(monster.baseName)] = monster.level;
             }
         }
-        heroes << level;
-        if (i < baseHeroes.size()-1) {
+    }
+    heroes << "[";
+    for (size_t i = 0; i < levels.size(); i++) {
+        heroes << levels[i];
+        if (i < levels.size()-1) {
             heroes << ",";
         }
     }
@@ -332,8 +515,33 @@ string Instance::toJSON() {
     s << "{";
         s << "\"target\""  << ":" << this->target.toJSON() << ",";
         s << "\"solution\""  << ":" << this->bestSolution.toJSON() << ",";
+        if (this->bestSolution.isEmpty() && !this->closestAttempt.isEmpty()) {
+            s << "\"closest\"" << ":" << "{";
+                s << "\"lineup\"" << ":" << this->closestAttempt.toJSON() << ",";
+                s << "\"kills\"" << ":" << (int) this->closestAttempt.lastFightData.monstersLost << ",";
+                s << "\"damage\"" << ":" << this->closestAttempt.lastFightData.damage;
+            s << "}" << ",";
+        }
+        if (this->solutions.size() > 1) {
+            s << "\"alternatives\"" << ":" << "[";
+            for (size_t i = 1; i < this->solutions.size(); i++) {
+                s << this->solutions[i].toJSON() << (i + 1 < this->solutions.size() ? "," : "");
+            }
+            s << "]" << ",";
+        }
+        if (!this->paretoFront.empty()) {
+            s << "\"front\"" << ":" << "[";
+            for (size_t i = 0; i < this->paretoFront.size(); i++) {
+                s << this->paretoFront[i].toJSON() << (i + 1 < this->paretoFront.size() ? "," : "");
+            }
+            s << "]" << ",";
+        }
         s << "\"time\""  << ":" << this->calculationTime << ",";
         s << "\"fights\"" << ":" << this->totalFightsSimulated << ",";
+        s << "\"metrics\"" << ":" << this->metrics.toJSON() << ",";
+        #ifdef COSMOS_COUNTERS
+        s << "\"counters\"" << ":" << this->counters.toJSON() << ",";
+        #endif
         s << "\"replay\"" << ":" << "\"" << makeBattleReplay(this->bestSolution, this->target) << "\"";
     s << "}";
     return s.str();
@@ -346,11 +554,35 @@ string Instance::toString() {
     // Announce the result
     if (!this->bestSolution.isEmpty()) {
         s << "  " << this->bestSolution.toString() << endl;
+        if (this->solutions.size() > 1) {
+            s << "  Alternatives:" << endl;
+            for (size_t i = 1; i < this->solutions.size(); i++) {
+                s << "    " << this->solutions[i].toString() << endl;
+            }
+        }
+        if (!this->paretoFront.empty()) {
+            s << "  Fewer heroes for more followers:" << endl;
+            for (size_t i = 0; i < this->paretoFront.size(); i++) {
+                s << "    " << this->paretoFront[i].toString() << endl;
+            }
+        }
     } else {
         s << endl << "Could not find a solution that beats this lineup." << endl;
+        if (!this->closestAttempt.isEmpty()) {
+            s << "  Closest attempt: " << this->closestAttempt.toString() << endl;
+            if ((size_t) this->closestAttempt.lastFightData.monstersLost >= this->targetSize) {
+                s << "  It kills all monsters but dies in the same turn, which counts as a loss." << endl;
+            } else {
+                s << "  It kills " << (int) this->closestAttempt.lastFightData.monstersLost << " of " << this->targetSize << " monsters and deals " << this->closestAttempt.lastFightData.damage << " damage to the next one." << endl;
+            }
+        }
     }
     s << "  " << this->totalFightsSimulated << " Fights simulated." << endl;
-    s << "  Total Calculation Time: " << this->calculationTime << endl << endl;
+    s << "  Total Calculation Time: " << this->calculationTime << endl;
+    if (this->metrics.peakResidentBytes > 0) {
+        s << "  Peak Memory: " << this->metrics.peakResidentBytes / (1024 * 1024) << " MB (" << this->metrics.peakFrontierBytes / (1024 * 1024) << " MB in armies)" << endl;
+    }
+    s << endl;
     if (!this->bestSolution.isEmpty()) {
         s << "Battle Replay (Use on Ingame Tournament Page):" << endl << makeBattleReplay(this->bestSolution, this->target) << endl << endl;
     }
@@ -381,4 +613,18 @@ string toLower(string input) {
         input[i] = tolower(input[i], locale());
     }
     return input;
+}
+
+// Escape a string so it can be embedded into a json string
+string escapeJSON(const string & input) {
+    string output;
+    for (size_t i = 0; i < input.size(); i++) {
+        if (input[i] == '"' || input[i] == '\\') {
+            output += '\\';
+        }
+        if ((unsigned char) input[i] >= ' ') {
+            output += input[i];
+        }
+    }
+    return output;
 }
\ No newline at end of file
@@ -7,10 +7,13 @@
 #include <iomanip>
 #include <fstream>
 #include <ostream>
+#include <sstream>
 #include <stdexcept>
 
 #include "cosmosDefines.h"
 #include "base64.h"
+#include "cosmosCounters.h"
+#include "cosmosMetrics.h"
 
 const size_t STANDARD_CMD_WIDTH = 80;
 const int INDENT_WIDTH = 2;
@@ -28,6 +31,7 @@ const std::string ELEMENT_SEPARATOR = ",";
 const std::string COMMENT_DELIMITOR = "//";
 const std::string QUEST_PREFIX = "quest";
 const std::string QUEST_NUMBER_SEPARTOR = "-";
+const std::string REPLAY_PREFIX = "replay:";   // Marks an ingame replay string in lineup input, it keeps its case
 
 const int REPLAY_EMPTY_SPOT = -1;
 
@@ -49,9 +53,14 @@ struct Instance {
     
     int followerUpperBound;
     Army bestSolution;
+    std::vector<Army> solutions; // Cheapest winning lineups, cheapest first. Only filled if the solver was asked for more than one
+    std::vector<Army> paretoFront; // Winning lineups that no other beats in followers and heroes, cheapest first. Only filled if asked for
+    Army closestAttempt; // Losing army within the bound that killed the most monsters, then dealt the most damage. Reported if nothing wins
     
     time_t calculationTime;
     int totalFightsSimulated = 0;
+    SolverMetrics metrics;
+    EngineCounters counters; // Only filled if compiled with COSMOS_COUNTERS
     
     std::string toString();
     std::string toJSON();
@@ -61,9 +70,12 @@ class IOManager {
     private:
         bool useMacroFile;
         bool showQueries = true;
+        bool interactive = true; // Ask on the command line once the macro input ends
         std::ifstream macroFile;
+        std::istringstream macroString;
+        std::istream * macroInput;
 
-        time_t lastTimedOutput = -1;
+        int64_t lastTimedOutput = -1; // Monotonic nanoseconds
         std::ostringstream outputStream;
         
         std::string getIndent(int indent);
@@ -76,9 +88,10 @@ class IOManager {
         IOManager();
         
         void initMacroFile(std::string macroFileName, bool showInput);
+        void initMacroString(std::string macroContent, bool showInput);
         std::string getResistantInput(std::string query, std::string help, QueryType queryType = raw);
         bool askYesNoQuestion(std::string question, std::string help, OutputLevel urgency, std::string defaultAnswer);
-        std::vector<int8_t> takeHerolevelInput();
+        std::vector<MonsterIndex> takeHerolevelInput();
         std::vector<Instance> takeInstanceInput(std::string promt);
         
         void outputMessage(std::string message, OutputLevel urgency, int indent = 0, bool linebreak = true);
@@ -103,7 +116,8 @@ const std::string lineupInputHelp =
     "For example: Typing " + QUEST_PREFIX + "23" + QUEST_NUMBER_SEPARTOR + "3 loads the lineup for the 23rd quest and tries to beat it with 4 monsters or less.\n"
     "  You can also enter multiple lineups at once. Do so by separating them with spaces.\n"
     "  Example: " + QUEST_PREFIX + "5" + QUEST_NUMBER_SEPARTOR + "3 a1" + ELEMENT_SEPARATOR + "a2" + ELEMENT_SEPARATOR + "a3 " + QUEST_PREFIX + "8" + QUEST_NUMBER_SEPARTOR + "1\n"
-    "  In this Example the program will calculate those three lineups one after another.\n";
+    "  In this Example the program will calculate those three lineups one after another.\n"
+    "  An ingame battle replay can be pasted as " + REPLAY_PREFIX + "replaystring to use the lineups of its right side.\n";
     
 const std::string minimumMonsterCostHelp = 
     "  This determines how expensive a monster needs to be in order for the calculator to consider it for a solution.\n"
@@ -122,17 +136,48 @@ const std::string maxFollowerHelp =
 // Convert a lineup string into an actual instance to solve
 Instance makeInstanceFromString(std::string instanceString);
 
+// Make an instance to solve with all slots available from a lineup
+Instance makeInstanceFromArmy(const Army & army);
+
 // Parse string linup input into actual monsters. If there are heroes in the input, a leveled hero is added to the database
 Army makeArmyFromStrings(std::vector<std::string> stringMonsters);
 
-// Parse hero input from a string into its name and level
-std::pair<Monster, int> parseHeroString(std::string heroString);
+// Parse hero input from a string into its index in baseHeroes and its level
+std::pair<size_t, int> parseHeroString(const std::string & heroString);
+
+// One unit of a replay lineup as it is stored in the replay
+struct ReplayUnit {
+    MonsterIndex monster = 0;   // Only for monsters
+    int hero = -1;              // Index into baseHeroes, -1 for monsters
+    int level = 0;
+};
+
+// Lineups of both sides of a battle replay, one army per tournament line that is not empty
+struct ReplayLineups {
+    std::vector<Army> friendly; // Left side, setup and shero in the replay
+    std::vector<Army> hostile;  // Right side, player and phero in the replay
+    std::vector<std::vector<ReplayUnit>> friendlyUnits; // The same lines unit by unit, heroes as base hero and level
+    std::vector<std::vector<ReplayUnit>> hostileUnits;
+};
+
+// Read the lineups of a base64 ingame replay string, with or without REPLAY_PREFIX. Heroes are added to the database at their replay levels
+// unless addHeroes is false, then only the units are read and the armies stay empty. Throws invalid_argument if the string is not a replay
+ReplayLineups decodeBattleReplay(std::string replay, bool addHeroes = true);
+
+// Check if a token of lineup input is a replay string
+bool isReplayString(const std::string & input);
+
+// Lower case the input and cut off comments. Replay strings are base64 and keep their case
+std::string normalizeInput(const std::string & input);
 
 // Functions for making a valid ingame replay string
 std::string makeBattleReplay(Army friendly, Army hostile);
+std::string makeTournamentReplay(std::vector<Army> friendly, std::vector<Army> hostile);
 std::string getReplaySetup(Army setup);
+std::string getReplaySetup(std::vector<Army> lines);
 std::string getReplayMonsterNumber(Monster monster);
 std::string getReplayHeroes(Army setup);
+std::string getReplayHeroes(std::vector<Army> lines);
 
 // Splits strings into a vector of strings. No need to optimize, only used for input.
 std::vector<std::string> split(std::string target, std::string separator);
@@ -140,4 +185,7 @@ std::vector<std::string> split(std::string target, std::string separator);
 // Convert a string to lowercase where available
 std::string toLower(std::string input);
 
+// Escape a string so it can be embedded into a json string
+std::string escapeJSON(const std::string & input);
+
 #endif
\ No newline at end of file
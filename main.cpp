@@ -1,395 +1,382 @@
 #include <iostream>
 #include <vector>
 #include <string>
-#include <algorithm>
-#include <ctime>
 #include <limits>
+#include <fstream>
+#include <memory>
+#include <algorithm>
 
 #include "inputProcessing.h"
 #include "cosmosDefines.h"
 #include "battleLogic.h"
+#include "solver.h"
+#include "solverServer.h"
+#include "cosmosData.h"
+#include "cosmosPlanning.h"
+#include "cosmosMultiTarget.h"
+#include "cosmosTournament.h"
+#include "cosmosDefense.h"
+#include "cosmosVerify.h"
 
 using namespace std;
 
 IOManager iomanager;
 
-// Simulates fights with all armies against the target. Armies will contain Army objects with the results written in.
-void simulateMultipleFights(vector<Army> & armies, Instance & instance) {
-    bool newFound = false;
-    size_t i = 0;
-    size_t armyAmount = armies.size();
-    
-    for (i = 0; i < armyAmount; i++) {
-        simulateFight(armies[i], instance.target);
-        if (!armies[i].lastFightData.rightWon) {  // left (our side) wins:
-            if (armies[i].followerCost < instance.followerUpperBound) {
-                if (!newFound) {
-                    iomanager.suspendTimedOutputs(DETAILED_OUTPUT);
-                }
-                newFound = true;
-                instance.followerUpperBound = armies[i].followerCost;
-                instance.bestSolution = armies[i];
-                iomanager.outputMessage(instance.bestSolution.toString(), DETAILED_OUTPUT, 2);
-            }
+const string METRICS_FLAG = "-metrics";
+const string SOLUTIONS_FLAG = "-solutions";
+const string PARETO_FLAG = "-pareto";
+const string PARETO_LEVELS_FLAG = "-pareto-levels";
+const string REQUIRE_FLAG = "-require";
+const string FORBID_FLAG = "-forbid";
+const string MAX_HEROES_FLAG = "-max-heroes";
+const string ELEMENTS_FLAG = "-elements";
+
+// Settings of a solver session taken from the command line
+struct SessionOptions {
+    size_t firstDominance = ARMY_MAX_BRUTEFORCEABLE_SIZE;   // Set this to control at which army length dominance should first be calculated. Treat with extreme caution. Not using dominance at all WILL use more RAM than you have
+    string metricsFileName = "";                            // Path of a file that receives solver timings, set with -metrics
+    bool perfCounters = false;                              // Report hardware counters per phase, set with -perf-counters
+    string traceFileName = "";                              // Path of a Chrome trace file of all solves, set with -trace
+    string progressFileName = "";                           // File or /dev/fd/n that receives progress events, set with -progress
+    vector<string> minLevelHeroes;                          // Heroes whose lowest winning level is searched instead of solving, set with -min-level
+    bool levelSweep = false;                                // Report how much leveling every hero saves, set with -level-sweep
+    size_t solutionAmount = 1;                              // Amount of cheapest lineups to output, set with -solutions
+    ParetoCriteria paretoCriteria = NO_PARETO;              // Output the pareto front over followers and heroes, set with -pareto or -pareto-levels
+    vector<string> requiredUnits;                           // Monsters and heroes every solution has to use, set with -require
+    vector<string> forbiddenUnits;                          // Monsters and heroes no solution may use, set with -forbid
+    int maxHeroes = -1;                                     // Most heroes a solution may use, set with -max-heroes
+    vector<string> elements;                                // Elements units may have, set with -elements
+    bool multiTarget = false;                               // Find one lineup that beats all lineups of an input, set with -multi-target
+    bool tournament = false;                                // Treat the lineups of an input as tournament lines that share the heroes, set with -tournament
+    bool defense = false;                                   // Search the hardest lineup to beat instead of solving, set with -defense
+    int defenseAttackerFollowers = -1;                      // Most followers an attacker of that lineup may use
+};
+
+// Check that every name is a monster or a hero and return them in lower case
+vector<string> parseUnitNames(const vector<string> & names) {
+    vector<string> units;
+    for (size_t i = 0; i < names.size(); i++) {
+        string name = toLower(names[i]);
+        if (monsterMap.count(name) == 0 && heroMap.count(name) == 0) {
+            throw runtime_error("Unknown monster or hero " + names[i]);
+        }
+        if (find(units.begin(), units.end(), name) == units.end()) {
+            units.push_back(name);
         }
     }
-    if (newFound) {
-        iomanager.resumeTimedOutputs(DETAILED_OUTPUT);
-    }
+    return units;
 }
 
-// Take the data from oldArmies and write all armies into newArmies with an additional monster at the end.
-// Armies that are dominated are ignored.
-void expand(vector<Army> & newPureArmies, vector<Army> & newHeroArmies, 
-            vector<Army> & oldPureArmies, vector<Army> & oldHeroArmies, 
-            size_t currentArmySize, Instance & instance) {
-
-    int remainingFollowers;
-    size_t availableMonstersSize = availableMonsters.size();
-    size_t availableHeroesSize = availableHeroes.size();
-    vector<bool> usedHeroes; usedHeroes.resize(availableHeroesSize, false);
-    size_t i, j, m;
-    SkillType currentSkill;
-    bool globalAbilityInfluence;
-    
-    for (i = 0; i < oldPureArmies.size(); i++) {
-        if (!oldPureArmies[i].lastFightData.dominated) {
-            remainingFollowers = instance.followerUpperBound - oldPureArmies[i].followerCost;
-            for (m = 0; m < availableMonstersSize && monsterReference[availableMonsters[m]].cost < remainingFollowers; m++) {
-                newPureArmies.push_back(oldPureArmies[i]);
-                newPureArmies.back().add(availableMonsters[m]);
-                newPureArmies.back().lastFightData.valid = true;
-            }
-            for (m = 0; m < availableHeroesSize; m++) {
-                currentSkill = monsterReference[availableHeroes[m]].skill.type;
-                newHeroArmies.push_back(oldPureArmies[i]);
-                newHeroArmies.back().add(availableHeroes[m]);
-                newHeroArmies.back().lastFightData.valid = (currentSkill == P_AOE || currentSkill == FRIENDS || currentSkill == BERSERK || currentSkill == ADAPT); // These skills are self centered
-            }
-        }
+// Turn the constraint flags into constraints for every solve
+LineupConstraints parseConstraints(const SessionOptions & options) {
+    LineupConstraints constraints;
+    constraints.required = parseUnitNames(options.requiredUnits);
+    constraints.forbidden = parseUnitNames(options.forbiddenUnits);
+    constraints.maxHeroes = options.maxHeroes;
+    if (constraints.required.size() > ARMY_MAX_SIZE) {
+        throw runtime_error("A lineup can't hold more than " + to_string(ARMY_MAX_SIZE) + " required units");
     }
-    
-    for (i = 0; i < oldHeroArmies.size(); i++) {
-        if (!oldHeroArmies[i].lastFightData.dominated) {
-            globalAbilityInfluence = false;
-            remainingFollowers = instance.followerUpperBound - oldHeroArmies[i].followerCost;
-            for (j = 0; j < currentArmySize; j++) {
-                for (m = 0; m < availableHeroesSize; m++) {
-                    if (oldHeroArmies[i].monsters[j] == availableHeroes[m]) {
-                        currentSkill = monsterReference[oldHeroArmies[i].monsters[j]].skill.type;
-                        globalAbilityInfluence |= (currentSkill == FRIENDS || currentSkill == RAINBOW);
-                        usedHeroes[m] = true;
-                        break;
-                    }
-                }
-            }
-            for (m = 0; m < availableMonstersSize && monsterReference[availableMonsters[m]].cost < remainingFollowers; m++) {
-                newHeroArmies.push_back(oldHeroArmies[i]);
-                newHeroArmies.back().add(availableMonsters[m]);
-                newHeroArmies.back().lastFightData.valid = !globalAbilityInfluence;
-            }
-            for (m = 0; m < availableHeroesSize; m++) {
-                if (!usedHeroes[m]) {
-                    currentSkill = monsterReference[availableHeroes[m]].skill.type;
-                    newHeroArmies.push_back(oldHeroArmies[i]);
-                    newHeroArmies.back().add(availableHeroes[m]);
-                    newHeroArmies.back().lastFightData.valid = (currentSkill == P_AOE || currentSkill == FRIENDS || currentSkill == BERSERK || currentSkill == ADAPT); // These skills are self centered
-                }
-                usedHeroes[m] = false;
-            }
+    for (size_t i = 0; i < options.elements.size(); i++) {
+        size_t element = find(ELEMENT_NAMES, ELEMENT_NAMES + FIRE + 1, toLower(options.elements[i])) - ELEMENT_NAMES;
+        if (element > FIRE) {
+            throw runtime_error("Unknown element " + options.elements[i]);
         }
+        constraints.elements.push_back((Element) element);
     }
+    return constraints;
 }
 
-// Use a greedy method to get a first upper bound on follower cost for the solution
-// Greedy approach for 4 or less monsters is obsolete, as bruteforce is still fast enough
-void getQuickSolutions(Instance & instance) {
-    Army tempArmy = Army();
-    vector<int8_t> greedy {};
-    vector<int8_t> greedyHeroes {};
-    vector<int8_t> greedyTemp {};
-    bool invalid = false;
-    
-    iomanager.outputMessage("Trying to find solutions greedily...", DETAILED_OUTPUT);
+void outputSolution(Instance instance) {
+    instance.bestSolution.lastFightData.valid = false;
+    simulateFight(instance.bestSolution, instance.target); // Sanity check on the solution
+    bool sane = !instance.bestSolution.lastFightData.rightWon || instance.bestSolution.isEmpty();
     
-    // Create Army that kills as many monsters as the army is big
-    if (instance.targetSize <= instance.maxCombatants) {
-        for (size_t i = 0; i < instance.maxCombatants; i++) {
-            for (size_t m = 0; m < availableMonsters.size(); m++) {
-                tempArmy = Army(greedy);
-                tempArmy.add(availableMonsters[m]);
-                simulateFight(tempArmy, instance.target);
-                if (!tempArmy.lastFightData.rightWon || (tempArmy.lastFightData.monstersLost > (int) i && i+1 < instance.maxCombatants)) { // the last monster has to win the encounter
-                    greedy.push_back(availableMonsters[m]);
-                    break;
-                }
-            }
-            invalid = greedy.size() < instance.maxCombatants;
+    if (iomanager.outputLevel == SERVER_OUTPUT) {
+        iomanager.outputMessage(instance.toJSON(), SERVER_OUTPUT);
+    } else {
+        iomanager.outputMessage(instance.toString(), CMD_OUTPUT);
+    }
+
+    if (!sane) {
+        cout << "  This does not beat the lineup!!!" << endl;
+        cout << "FATAL ERROR!!! Please comment this output in the Forums!" << endl;
+    }
+}
+
+// Append timings and frontier sizes of a solved instance as a line of json to a file
+void outputMetrics(Instance & instance, string metricsFileName) {
+    ofstream metricsFile(metricsFileName, ios::app);
+    metricsFile << "{";
+        metricsFile << "\"target\"" << ":" << instance.target.toJSON() << ",";
+        metricsFile << "\"fights\"" << ":" << instance.totalFightsSimulated << ",";
+        metricsFile << "\"metrics\"" << ":" << instance.metrics.toJSON();
+        #ifdef COSMOS_COUNTERS
+        metricsFile << "," << "\"counters\"" << ":" << instance.counters.toJSON();
+        #endif
+    metricsFile << "}" << endl;
+}
+
+// Search the lowest winning level of every hero for an instance and output the results
+void outputMinimumLevels(Instance & instance, SolverContext & context, const vector<size_t> & heroes) {
+    LevelPlanner planner(instance, context);
+    for (size_t i = 0; i < heroes.size(); i++) {
+        HeroLevelResult result = planner.findMinimumLevel(heroes[i]);
+        if (iomanager.outputLevel == SERVER_OUTPUT) {
+            iomanager.outputMessage(result.toJSON(), SERVER_OUTPUT);
+        } else {
+            iomanager.outputMessage(result.toString(), CMD_OUTPUT);
         }
-        if (!invalid) {
-            instance.bestSolution = tempArmy;
-            if (instance.followerUpperBound > tempArmy.followerCost) {
-                instance.followerUpperBound = tempArmy.followerCost;
-            }
-            
-            // Try to replace monsters in the setup with heroes to save followers
-            greedyHeroes = greedy;
-            for (size_t m = 0; m < availableHeroes.size(); m++) {
-                for (size_t i = 0; i < greedyHeroes.size(); i++) {
-                    greedyTemp = greedyHeroes;
-                    greedyTemp[i] = availableHeroes[m];
-                    tempArmy = Army(greedyTemp);
-                    simulateFight(tempArmy, instance.target);
-                    if (!tempArmy.lastFightData.rightWon) { // Setup still needs to win
-                        greedyHeroes = greedyTemp;
-                        break;
-                    }
-                }
-            }
-            tempArmy = Army(greedyHeroes);
-            instance.bestSolution = tempArmy;
-            if (instance.followerUpperBound > tempArmy.followerCost) { // Take care not to override custom follower counts
-                instance.followerUpperBound = tempArmy.followerCost;
-            }
+    }
+}
+
+// Solve an instance with every hero leveled up a bit and output the best costs
+void outputLevelSweep(Instance & instance, SolverContext & context, LevelSweepTotals & totals) {
+    vector<LevelSweepResult> results = sweepHeroLevels(instance, context);
+    totals.add(results);
+    if (iomanager.outputLevel == SERVER_OUTPUT) {
+        iomanager.outputMessage(levelSweepToJSON(instance, results), SERVER_OUTPUT);
+    } else {
+        iomanager.outputMessage(levelSweepToString(instance, results), CMD_OUTPUT);
+    }
+}
+
+// Solve all lineups of an input as one multi target instance and output the result
+void outputMultiTarget(vector<Instance> & instances, SolverContext & context, int followerUpperBound) {
+    MultiTargetInstance combined = combineInstances(instances, followerUpperBound);
+    solveMultiTarget(combined, context);
+    if (iomanager.outputLevel == SERVER_OUTPUT) {
+        iomanager.outputMessage(combined.toJSON(), SERVER_OUTPUT);
+    } else {
+        iomanager.outputMessage(combined.toString(), CMD_OUTPUT);
+    }
+    for (size_t i = 0; i < combined.targets.size() && !combined.bestSolution.isEmpty(); i++) {
+        Army solution = combined.bestSolution;
+        solution.lastFightData.valid = false;
+        simulateFight(solution, combined.targets[i]); // Sanity check on the solution
+        if (solution.lastFightData.rightWon) {
+            cout << "  This does not beat " << combined.targets[i].toString() << "!!!" << endl;
+            cout << "FATAL ERROR!!! Please comment this output in the Forums!" << endl;
         }
     }
 }
 
-// Main method for solving an instance. Returns time taken to calculate in seconds
-void solveInstance(Instance & instance, size_t firstDominance) {
-    Army tempArmy = Army();
-    time_t startTime;
-    
-    size_t i, j, sj, si;
+// Solve all lineups of an input as the lines of a tournament and output the assignment
+void outputTournament(vector<Instance> & instances, SolverContext & context) {
+    TournamentResult result = solveTournament(instances, context);
+    if (iomanager.outputLevel == SERVER_OUTPUT) {
+        iomanager.outputMessage(result.toJSON(), SERVER_OUTPUT);
+    } else {
+        iomanager.outputMessage(result.toString(), CMD_OUTPUT);
+    }
+}
 
-    // Get first Upper limit on followers
-    if (instance.maxCombatants > ARMY_MAX_BRUTEFORCEABLE_SIZE) {
-        getQuickSolutions(instance);
+// Search the hardest lineup to beat with the roster and output it
+void outputDefense(SolverContext & context, int defenseFollowers, int attackerFollowers) {
+    DefenseResult result = searchDefense(context, defenseFollowers, attackerFollowers);
+    if (iomanager.outputLevel == SERVER_OUTPUT) {
+        iomanager.outputMessage(result.toJSON(), SERVER_OUTPUT);
+    } else {
+        iomanager.outputMessage(result.toString(), CMD_OUTPUT);
     }
-    
-    vector<Army> pureMonsterArmies {}; // initialize with all monsters
-    vector<Army> heroMonsterArmies {}; // initialize with all heroes
-    for (i = 0; i < availableMonsters.size(); i++) {
-        if (monsterReference[availableMonsters[i]].cost <= instance.followerUpperBound) {
-            pureMonsterArmies.push_back(Army( {availableMonsters[i]} ));
+}
+
+// Collect roster and lineups via the iomanager and solve them until the user is done
+void runSolverSession(const SessionOptions & options) {
+    int32_t minimumMonsterCost;
+    int32_t userFollowerUpperBound;
+    vector<Instance> instances;
+    bool userWantsContinue;
+    SolverContext context;
+    context.io = &iomanager;
+    context.firstDominance = options.firstDominance;
+    context.solutionAmount = options.solutionAmount;
+    context.paretoCriteria = options.paretoCriteria;
+    context.perfCounters = options.perfCounters;
+    unique_ptr<TraceWriter> trace;
+    if (!options.traceFileName.empty()) {
+        trace.reset(new TraceWriter(options.traceFileName));
+        if (!trace->isOpen()) {
+            throw runtime_error("Could not open trace file " + options.traceFileName);
         }
+        context.trace = trace.get();
     }
-    for (i = 0; i < availableHeroes.size(); i++) { // Ignore chacking for Hero Cost
-        heroMonsterArmies.push_back(Army( {availableHeroes[i]} ));
+    unique_ptr<ProgressStream> progress;
+    if (!options.progressFileName.empty()) {
+        progress.reset(new ProgressStream(options.progressFileName));
+        if (!progress->isOpen()) {
+            throw runtime_error("Could not open progress file " + options.progressFileName);
+        }
+        context.progress = progress.get();
     }
     
-    // Check if a single monster can beat the last two monsters of the target. If not, solutions that can only beat n-2 monsters need not be expanded later
-    bool optimizable = (instance.targetSize > ARMY_MAX_BRUTEFORCEABLE_SIZE && instance.targetSize > 3);
-    if (optimizable) {
-        tempArmy = Army({instance.target.monsters[instance.targetSize - 2], instance.target.monsters[instance.targetSize - 1]}); // Make an army from the last two monsters
+    context.constraints = parseConstraints(options);
+    if (!context.constraints.isEmpty() && (!options.minLevelHeroes.empty() || options.levelSweep || options.multiTarget || options.defense)) {
+        throw runtime_error("Constraints can't be combined with " + MIN_LEVEL_FLAG + ", " + LEVEL_SWEEP_FLAG + ", " + MULTI_TARGET_FLAG + " or " + DEFENSE_FLAG);
     }
     
-    if (optimizable) { // Check with normal Mobs
-        for (i = 0; i < pureMonsterArmies.size(); i++) {
-            simulateFight(pureMonsterArmies[i], tempArmy);
-            if (!pureMonsterArmies[i].lastFightData.rightWon) { // Monster won the fight
-                optimizable = false;
-                break;
-            }
+    vector<size_t> minLevelHeroes;
+    for (size_t i = 0; i < options.minLevelHeroes.size(); i++) {
+        auto hero = heroMap.find(toLower(options.minLevelHeroes[i]));
+        if (hero == heroMap.end()) {
+            throw runtime_error("Unknown hero " + options.minLevelHeroes[i]);
         }
+        minLevelHeroes.push_back((size_t) hero->second);
     }
-
-    if (optimizable) { // Check with Heroes
-        for (i = 0; i < heroMonsterArmies.size(); i++) {
-            simulateFight(heroMonsterArmies[i], tempArmy);
-            if (!heroMonsterArmies[i].lastFightData.rightWon) { // Hero won the fight
-                optimizable = false;
-                break;
-            }
-        }
+    
+    // Collect the Data via Command Line
+    context.availableHeroes = iomanager.takeHerolevelInput();
+    minimumMonsterCost = stoi(iomanager.getResistantInput("Set a lower follower limit on monsters used: ", minimumMonsterCostHelp, integer));
+    userFollowerUpperBound = stoi(iomanager.getResistantInput("Set an upper follower limit that you want to use: ", maxFollowerHelp, integer));
+    
+    // Fill monster arrays with relevant monsters
+    context.availableMonsters = filterMonsterData(minimumMonsterCost);
+    
+    if (options.defense) {
+        outputDefense(context, userFollowerUpperBound, options.defenseAttackerFollowers);
+        return; // There are no lineups to enter
     }
-
-    // Run the Bruteforce Loop
-    startTime = time(NULL);
-    size_t pureMonsterArmiesSize, heroMonsterArmiesSize;
-    for (size_t armySize = 1; armySize <= instance.maxCombatants; armySize++) {
     
-        pureMonsterArmiesSize = pureMonsterArmies.size();
-        heroMonsterArmiesSize = heroMonsterArmies.size();
-        // Output Debug Information
-        iomanager.outputMessage("Starting loop for armies of size " + to_string(armySize), BASIC_OUTPUT);
-        
-        // Run Fights for non-Hero setups
-        iomanager.timedOutput("Simulating " + to_string(pureMonsterArmiesSize) + " non-hero Fights... ", DETAILED_OUTPUT, 1, true);
-        simulateMultipleFights(pureMonsterArmies, instance);
+    do {
+        instances = iomanager.takeInstanceInput("Enter Enemy Lineup(s): ");
+        iomanager.outputMessage("\nCalculating with " + to_string(context.availableMonsters.size()) + " available Monsters and " + to_string(context.availableHeroes.size()) + " enabled Heroes.", CMD_OUTPUT);
         
-        // Run fights for setups with heroes
-        iomanager.timedOutput("Simulating " + to_string(heroMonsterArmiesSize) + " hero Fights... ", DETAILED_OUTPUT, 1);
-        simulateMultipleFights(heroMonsterArmies, instance);
+        if (iomanager.outputLevel == CMD_OUTPUT) {
+            if (instances.size() > 1) {
+                iomanager.outputLevel = SOLUTION_OUTPUT;
+            } else {
+                iomanager.outputLevel = BASIC_OUTPUT;
+            }
+        }
         
-        // If we have a valid solution with 0 followers there is no need to continue
-        if (instance.bestSolution.monsterAmount > 0 && instance.bestSolution.followerCost == 0) { break; }
+        if (options.multiTarget) {
+            outputMultiTarget(instances, context, userFollowerUpperBound < 0 ? numeric_limits<int>::max() : userFollowerUpperBound);
+            instances.clear(); // Already solved together
+        }
+        if (options.tournament) {
+            for (size_t i = 0; i < instances.size(); i++) {
+                instances[i].followerUpperBound = userFollowerUpperBound < 0 ? numeric_limits<int>::max() : userFollowerUpperBound;
+            }
+            outputTournament(instances, context);
+            instances.clear(); // Already solved together
+        }
         
-        if (armySize < instance.maxCombatants) { 
-            // Sort the results by follower cost for some optimization
-            iomanager.timedOutput("Sorting Lists... ", DETAILED_OUTPUT, 1);
-            sort(pureMonsterArmies.begin(), pureMonsterArmies.end(), hasFewerFollowers);
-            sort(heroMonsterArmies.begin(), heroMonsterArmies.end(), hasFewerFollowers);
-                
-            if (armySize == firstDominance && iomanager.outputLevel == BASIC_OUTPUT) {
-                iomanager.outputLevel = DETAILED_OUTPUT; // Switch output level after pure brutefore is exhausted
+        LevelSweepTotals sweepTotals;
+        for (size_t i = 0; i < instances.size(); i++) {
+            if (userFollowerUpperBound < 0) {
+                instances[i].followerUpperBound = numeric_limits<int>::max();
+            } else {
+                instances[i].followerUpperBound = userFollowerUpperBound;
             }
-            if (armySize == firstDominance) {
-                iomanager.outputMessage("", DETAILED_OUTPUT);
-                if (!instance.bestSolution.isEmpty()) {
-                    iomanager.outputMessage("Best Solution so far:", DETAILED_OUTPUT);
-                    iomanager.outputMessage(instance.bestSolution.toString(), DETAILED_OUTPUT, 1);
-                } else {
-                    iomanager.outputMessage("Could not find a solution yet!", DETAILED_OUTPUT);
-                }
-                if (!iomanager.askYesNoQuestion("Continue calculation?", "  Continuing will most likely result in a cheaper solution but could consume a lot of RAM.\n", DETAILED_OUTPUT, POSITIVE_ANSWER)) {return;}
-                startTime = time(NULL);
-                iomanager.outputMessage("\nPreparing to work on loop for armies of size " + to_string(armySize+1), BASIC_OUTPUT);
-                iomanager.outputMessage("Currently considering " + to_string(pureMonsterArmies.size()) + " normal and " + to_string(heroMonsterArmies.size()) + " hero armies.", BASIC_OUTPUT);
+            
+            if (!minLevelHeroes.empty()) {
+                outputMinimumLevels(instances[i], context, minLevelHeroes);
+                continue;
             }
-                
-            if (firstDominance <= armySize) {
-                // Calculate which results are strictly better than others (dominance)
-                iomanager.timedOutput("Calculating Dominance for non-heroes... ", DETAILED_OUTPUT, 1, firstDominance == armySize);
-                
-                int leftFollowerCost;
-                FightResult * currentFightResult;
-                int8_t leftHeroList[ARMY_MAX_SIZE];
-                size_t leftHeroListSize;
-                int8_t rightMonster;
-                int8_t leftMonster;
-                // First Check dominance for non-Hero setups
-                for (i = 0; i < pureMonsterArmiesSize; i++) {
-                    leftFollowerCost = pureMonsterArmies[i].followerCost;
-                    currentFightResult = &pureMonsterArmies[i].lastFightData;
-                    // A result is obsolete if only one expansion is left but no single mob can beat the last two enemy mobs alone (optimizable)
-                    if (armySize == (instance.maxCombatants - 1) && optimizable) {
-                        // TODO: Investigate whether this is truly correct: What if the second-to-last mob is already damaged (not from aoe) i.e. it defeated the last mob of left?
-                        if (currentFightResult->rightWon && currentFightResult->monstersLost < (int) (instance.targetSize - 2) && currentFightResult->rightAoeDamage == 0) {
-                            currentFightResult->dominated = true;
-                        }
-                    }
-                    // A result is dominated If:
-                    if (!currentFightResult->dominated) { 
-                        // Another pureResults got farther with a less costly lineup
-                        for (j = i+1; j < pureMonsterArmiesSize; j++) {
-                            if (leftFollowerCost < pureMonsterArmies[j].followerCost) {
-                                break; 
-                            } else if (*currentFightResult <= pureMonsterArmies[j].lastFightData) { // currentFightResult has more followers implicitly 
-                                currentFightResult->dominated = true;
-                                break;
-                            }
-                        }
-                        // A lineup without heroes is better than a setup with heroes even if it got just as far
-                        for (j = 0; j < heroMonsterArmiesSize; j++) {
-                            if (leftFollowerCost > heroMonsterArmies[j].followerCost) {
-                                break; 
-                            } else if (heroMonsterArmies[j].lastFightData <= *currentFightResult) { // currentFightResult has less followers implicitly
-                                heroMonsterArmies[j].lastFightData.dominated = true;
-                            }                       
-                        }
-                    }
-                }
-                
-                iomanager.timedOutput("Calculating Dominance for heroes... ", DETAILED_OUTPUT, 1);
-                // Domination for setups with heroes
-                bool usedHeroSubset, leftUsedHero;
-                for (i = 0; i < heroMonsterArmiesSize; i++) {
-                    leftFollowerCost = heroMonsterArmies[i].followerCost;
-                    currentFightResult = &heroMonsterArmies[i].lastFightData;
-                    leftHeroListSize = 0;
-                    for (si = 0; si < armySize; si++) {
-                        leftMonster = heroMonsterArmies[i].monsters[si];
-                        if (monsterReference[leftMonster].rarity != NO_HERO) {
-                            leftHeroList[leftHeroListSize] = leftMonster;
-                            leftHeroListSize++;
-                        }
-                    }
-                    
-                    // A result is obsolete if only one expansion is left but no single mob can beat the last two enemy mobs alone (optimizable)
-                    if (armySize == (instance.maxCombatants - 1) && optimizable && currentFightResult->rightAoeDamage == 0) {
-                        // TODO: Investigate whether this is truly correct: What if the second-to-last mob is already damaged (not from aoe) i.e. it defeated the last mob of left?
-                        if (currentFightResult->rightWon && currentFightResult->monstersLost < (int) (instance.targetSize - 2)){
-                            currentFightResult->dominated = true;
-                        }
-                    }
-                    
-                    // A result is dominated If:
-                    if (!currentFightResult->dominated) {
-                        // if i costs more followers and got less far than j, then i is dominated
-                        for (j = i+1; j < heroMonsterArmiesSize; j++) {
-                            if (leftFollowerCost < heroMonsterArmies[j].followerCost) {
-                                break;
-                            } else if (*currentFightResult <= heroMonsterArmies[j].lastFightData) { // i has more followers implicitly
-                                usedHeroSubset = true; // If j doesn't use a strict subset of the heroes i used, it cannot dominate i
-                                for (sj = 0; sj < armySize; sj++) { // for every hero in j there must be the same hero in i
-                                    leftUsedHero = false; 
-                                    rightMonster = heroMonsterArmies[j].monsters[sj];
-                                    if (monsterReference[rightMonster].rarity != NO_HERO) {
-                                        for (si = 0; si < leftHeroListSize; si++) {
-                                            if (leftHeroList[si] == rightMonster) {
-                                                leftUsedHero = true;
-                                                break;
-                                            }
-                                        }
-                                        if (!leftUsedHero) {
-                                            usedHeroSubset = false;
-                                            break;
-                                        }
-                                    }
-                                }
-                                if (usedHeroSubset) {
-                                    currentFightResult->dominated = true;
-                                    break;
-                                }                           
-                            }
-                        }
-                    }
-                }
+            if (options.levelSweep) {
+                outputLevelSweep(instances[i], context, sweepTotals);
+                continue;
+            }
+            solveInstance(instances[i], context);
+            outputSolution(instances[i]);
+            if (options.perfCounters) {
+                iomanager.outputMessage(instances[i].metrics.hardwareReport(), CMD_OUTPUT);
             }
-            // now we expand to add the next monster to all non-dominated armies
-            iomanager.timedOutput("Expanding Lineups by one... ", DETAILED_OUTPUT, 1);
-            vector<Army> nextPureArmies;
-            vector<Army> nextHeroArmies;
-            expand(nextPureArmies, nextHeroArmies, pureMonsterArmies, heroMonsterArmies, armySize, instance);
+            if (!options.metricsFileName.empty()) {
+                outputMetrics(instances[i], options.metricsFileName);
+            }
+        }
+        if (options.levelSweep && instances.size() > 1) {
+            if (iomanager.outputLevel == SERVER_OUTPUT) {
+                iomanager.outputMessage(sweepTotals.toJSON(), SERVER_OUTPUT);
+            } else {
+                iomanager.outputMessage(sweepTotals.toString(), VITAL_OUTPUT);
+            }
+        }
+        userWantsContinue = iomanager.askYesNoQuestion("Do you want to calculate more lineups?", "", CMD_OUTPUT, NEGATIVE_ANSWER);
+    } while (userWantsContinue);
+}
 
-            iomanager.timedOutput("Moving Data... ", DETAILED_OUTPUT, 1);
-            pureMonsterArmies = move(nextPureArmies);
-            heroMonsterArmies = move(nextHeroArmies);
+// Read the solver flags that follow the macro file or the listen address
+SessionOptions parseSessionOptions(int argc, char** argv) {
+    SessionOptions options;
+    for (int i = 2; i < argc; i++) {
+        if ((string) argv[i] == METRICS_FLAG && i + 1 < argc) {
+            options.metricsFileName = argv[i+1];
+        }
+        if ((string) argv[i] == TRACE_FLAG && i + 1 < argc) {
+            options.traceFileName = argv[i+1];
+        }
+        if ((string) argv[i] == PROGRESS_FLAG && i + 1 < argc) {
+            options.progressFileName = argv[i+1];
+        }
+        if ((string) argv[i] == MIN_LEVEL_FLAG && i + 1 < argc) {
+            options.minLevelHeroes = split(argv[i+1], ELEMENT_SEPARATOR);
+        }
+        if ((string) argv[i] == SOLUTIONS_FLAG && i + 1 < argc) {
+            options.solutionAmount = (size_t) max(1, atoi(argv[i+1]));
+        }
+        if ((string) argv[i] == PARETO_FLAG) {
+            options.paretoCriteria = PARETO_HEROES;
+        }
+        if ((string) argv[i] == PARETO_LEVELS_FLAG) {
+            options.paretoCriteria = PARETO_HERO_LEVELS;
+        }
+        if ((string) argv[i] == REQUIRE_FLAG && i + 1 < argc) {
+            options.requiredUnits = split(argv[i+1], ELEMENT_SEPARATOR);
+        }
+        if ((string) argv[i] == FORBID_FLAG && i + 1 < argc) {
+            options.forbiddenUnits = split(argv[i+1], ELEMENT_SEPARATOR);
+        }
+        if ((string) argv[i] == MAX_HEROES_FLAG && i + 1 < argc) {
+            options.maxHeroes = max(0, atoi(argv[i+1]));
+        }
+        if ((string) argv[i] == ELEMENTS_FLAG && i + 1 < argc) {
+            options.elements = split(argv[i+1], ELEMENT_SEPARATOR);
+        }
+        if ((string) argv[i] == TOURNAMENT_FLAG) {
+            options.tournament = true;
+        }
+        if ((string) argv[i] == DEFENSE_FLAG && i + 1 < argc) {
+            options.defense = true;
+            options.defenseAttackerFollowers = atoi(argv[i+1]);
+        }
+        if ((string) argv[i] == MULTI_TARGET_FLAG) {
+            options.multiTarget = true;
+        }
+        if ((string) argv[i] == LEVEL_SWEEP_FLAG) {
+            options.levelSweep = true;
+        }
+        if ((string) argv[i] == PERF_COUNTERS_FLAG) {
+            options.perfCounters = true;
         }
-        iomanager.finishTimedOutput(DETAILED_OUTPUT);
     }
-    instance.calculationTime = time(NULL) - startTime;
+    return options;
 }
 
-void outputSolution(Instance instance) {
-    instance.bestSolution.lastFightData.valid = false;
-    simulateFight(instance.bestSolution, instance.target); // Sanity check on the solution
-    bool sane = !instance.bestSolution.lastFightData.rightWon || instance.bestSolution.isEmpty();
-    
-    if (iomanager.outputLevel == SERVER_OUTPUT) {
-        iomanager.outputMessage(instance.toJSON(), SERVER_OUTPUT);
-    } else {
-        iomanager.outputMessage(instance.toString(), CMD_OUTPUT);
+// Fight all lineup pairs of a file and write the results to another file or to stdout if none is given
+void runVerification(const string & pairsFileName, const string & resultsFileName) {
+    ifstream pairsFile(pairsFileName);
+    if (!pairsFile.is_open()) {
+        throw runtime_error("Could not open pairs file " + pairsFileName);
     }
-
-    if (!sane) {
-        cout << "  This does not beat the lineup!!!" << endl;
-        cout << "FATAL ERROR!!! Please comment this output in the Forums!" << endl;
+    if (resultsFileName.empty()) {
+        verifyLineups(pairsFile, cout);
+        return;
+    }
+    ofstream resultsFile(resultsFileName);
+    if (!resultsFile.is_open()) {
+        throw runtime_error("Could not open results file " + resultsFileName);
     }
+    cout << verifyLineups(pairsFile, resultsFile).toString();
 }
 
 int main(int argc, char** argv) {
     
     // Declare Variables
     vector<int> heroLevels;
-    int32_t minimumMonsterCost;
-    int32_t userFollowerUpperBound;
-    vector<Instance> instances;
-    bool userWantsContinue;
  
     // Define User Input Data
-    size_t firstDominance = ARMY_MAX_BRUTEFORCEABLE_SIZE;   // Set this to control at which army length dominance should first be calculated. Treat with extreme caution. Not using dominance at all WILL use more RAM than you have
+    SessionOptions options = parseSessionOptions(argc, argv);
     string macroFileName = "default.cqinput";               // Path to default macro file
 
     // Flow Control Variables
@@ -397,6 +384,48 @@ int main(int argc, char** argv) {
     bool showMacroFileInput = true;     // Set this to true to see what the macrofile inputs
     bool individual = false;            // Set this to true if you want to simulate individual fights (lineups will be promted when you run the program)
     
+    // Initialize global Data
+    try {
+        for (int i = 1; i + 1 < argc; i++) {
+            if ((string) argv[i] == DATA_FLAG) {
+                loadGameData(argv[i+1]);
+            }
+        }
+        initMonsterData();
+        for (int i = 1; i + 1 < argc; i++) {
+            if ((string) argv[i] == EXPORT_DATA_FLAG) {
+                exportGameData(argv[i+1]);
+                return EXIT_SUCCESS;
+            }
+            if ((string) argv[i] == EXPORT_HEADER_FLAG) {
+                exportGameDataHeader(argv[i+1]);
+                return EXIT_SUCCESS;
+            }
+            if ((string) argv[i] == VERIFY_FLAG) {
+                string resultsFileName = "";
+                for (int j = 1; j + 1 < argc; j++) {
+                    if ((string) argv[j] == VERIFY_OUTPUT_FLAG) {
+                        resultsFileName = argv[j+1];
+                    }
+                }
+                runVerification(argv[i+1], resultsFileName);
+                return EXIT_SUCCESS;
+            }
+        }
+    } catch (const exception & e) {
+        cout << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+    
+    // Serve solve requests over a socket. Every request is a macro file answered by a worker process
+    if (argc >= 3 && (string) argv[1] == LISTEN_FLAG) {
+        return runServer(parseServerConfig(argc, argv, 1), [options](const string & request) {
+            iomanager.initMacroString(request, false);
+            iomanager.outputLevel = SERVER_OUTPUT;
+            runSolverSession(options);
+        });
+    }
+    
     iomanager.outputLevel = CMD_OUTPUT;
     // Check if the user provided a filename to be used as a macro file
     if (argc >= 2) {
@@ -410,63 +439,35 @@ int main(int argc, char** argv) {
         iomanager.initMacroFile(macroFileName, showMacroFileInput);
     }
     
-    // Initialize global Data
-    initMonsterData();
-    
     // -------------------------------------------- Program Start --------------------------------------------    
     
     iomanager.outputMessage(welcomeMessage, CMD_OUTPUT);
     iomanager.outputMessage(helpMessage, CMD_OUTPUT);
     
-    if (individual) {
-        iomanager.outputMessage("Simulating individual Figths", CMD_OUTPUT);
-        while (true) {
-            Army left = iomanager.takeInstanceInput("Enter friendly lineup: ")[0].target;
-            Army right = iomanager.takeInstanceInput("Enter hostile lineup: ")[0].target;
-            simulateFight(left, right, true);
-            iomanager.outputMessage(to_string(left.lastFightData.rightWon) + " " + to_string(left.followerCost) + " " + to_string(right.followerCost), CMD_OUTPUT);
-            
-            if (!iomanager.askYesNoQuestion("Simulate another Fight?", "", CMD_OUTPUT, NEGATIVE_ANSWER)) {
-                break;
-            }
-        }
-        return EXIT_SUCCESS;
-    }
-    
-    // Collect the Data via Command Line
-    availableHeroes = iomanager.takeHerolevelInput();
-    minimumMonsterCost = stoi(iomanager.getResistantInput("Set a lower follower limit on monsters used: ", minimumMonsterCostHelp, integer));
-    userFollowerUpperBound = stoi(iomanager.getResistantInput("Set an upper follower limit that you want to use: ", maxFollowerHelp, integer));
-    
-    // Fill monster arrays with relevant monsters
-    filterMonsterData(minimumMonsterCost);
-    
-    do {
-        instances = iomanager.takeInstanceInput("Enter Enemy Lineup(s): ");
-        iomanager.outputMessage("\nCalculating with " + to_string(availableMonsters.size()) + " available Monsters and " + to_string(availableHeroes.size()) + " enabled Heroes.", CMD_OUTPUT);
-        
-        if (iomanager.outputLevel == CMD_OUTPUT) {
-            if (instances.size() > 1) {
-                iomanager.outputLevel = SOLUTION_OUTPUT;
-            } else {
-                iomanager.outputLevel = BASIC_OUTPUT;
+    try {
+        if (individual) {
+            iomanager.outputMessage("Simulating individual Figths", CMD_OUTPUT);
+            while (true) {
+                Army left = iomanager.takeInstanceInput("Enter friendly lineup: ")[0].target;
+                Army right = iomanager.takeInstanceInput("Enter hostile lineup: ")[0].target;
+                simulateFight(left, right, true);
+                iomanager.outputMessage(to_string(left.lastFightData.rightWon) + " " + to_string(left.followerCost) + " " + to_string(right.followerCost), CMD_OUTPUT);
+                
+                if (!iomanager.askYesNoQuestion("Simulate another Fight?", "", CMD_OUTPUT, NEGATIVE_ANSWER)) {
+                    break;
+                }
             }
+            return EXIT_SUCCESS;
         }
         
-        for (size_t i = 0; i < instances.size(); i++) {
-            totalFightsSimulated = &(instances[i].totalFightsSimulated);
-            
-            if (userFollowerUpperBound < 0) {
-                instances[i].followerUpperBound = numeric_limits<int>::max();
-            } else {
-                instances[i].followerUpperBound = userFollowerUpperBound;
-            }
-            
-            solveInstance(instances[i], firstDominance);
-            outputSolution(instances[i]);
-        }
-        userWantsContinue = iomanager.askYesNoQuestion("Do you want to calculate more lineups?", "", CMD_OUTPUT, NEGATIVE_ANSWER);
-    } while (userWantsContinue);
+        runSolverSession(options);
+    } catch (const runtime_error & e) {
+        iomanager.outputMessage(e.what(), VITAL_OUTPUT);
+        return EXIT_FAILURE;
+    } catch (const length_error & e) { // Too many leveled heroes
+        iomanager.outputMessage(e.what(), VITAL_OUTPUT);
+        return EXIT_FAILURE;
+    }
     
     iomanager.outputMessage("", CMD_OUTPUT);
     iomanager.haltExecution();
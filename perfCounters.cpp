@@ -0,0 +1,113 @@
+#include "perfCounters.h"
+
+#include <sstream>
+#include <iomanip>
+
+#ifdef __linux__
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+static const uint64_t HARDWARE_EVENT_CONFIGS[HARDWARE_EVENT_AMOUNT] {
+    PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+};
+
+// Open a single user space counter for the calling thread on any cpu
+static int openHardwareEvent(uint64_t config) {
+    perf_event_attr attributes;
+    memset(&attributes, 0, sizeof(attributes));
+    attributes.type = PERF_TYPE_HARDWARE;
+    attributes.size = sizeof(attributes);
+    attributes.config = config;
+    attributes.disabled = 1;
+    attributes.exclude_kernel = 1;
+    attributes.exclude_hv = 1;
+    return (int) syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+}
+
+PerfCounters::PerfCounters() {
+    for (size_t i = 0; i < HARDWARE_EVENT_AMOUNT; i++) {
+        this->fds[i] = openHardwareEvent(HARDWARE_EVENT_CONFIGS[i]);
+        if (this->fds[i] >= 0) {
+            ioctl(this->fds[i], PERF_EVENT_IOC_RESET, 0);
+            ioctl(this->fds[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    this->lastRead = this->read();
+}
+
+PerfCounters::~PerfCounters() {
+    for (size_t i = 0; i < HARDWARE_EVENT_AMOUNT; i++) {
+        if (this->fds[i] >= 0) {
+            close(this->fds[i]);
+        }
+    }
+}
+
+HardwareCounts PerfCounters::read() {
+    HardwareCounts counts;
+    uint64_t value;
+    for (size_t i = 0; i < HARDWARE_EVENT_AMOUNT; i++) {
+        if (this->fds[i] >= 0 && ::read(this->fds[i], &value, sizeof(value)) == sizeof(value)) {
+            counts.events[i] = value;
+        }
+    }
+    return counts;
+}
+#else
+PerfCounters::PerfCounters() {
+    for (size_t i = 0; i < HARDWARE_EVENT_AMOUNT; i++) {
+        this->fds[i] = -1;
+    }
+}
+
+PerfCounters::~PerfCounters() {}
+
+HardwareCounts PerfCounters::read() {
+    return HardwareCounts();
+}
+#endif
+
+// Cycles are required, everything else is optional on some cpus
+bool PerfCounters::available() const {
+    return this->fds[CYCLES_EVENT] >= 0;
+}
+
+HardwareCounts PerfCounters::lap() {
+    HardwareCounts current = this->read();
+    HardwareCounts difference;
+    for (size_t i = 0; i < HARDWARE_EVENT_AMOUNT; i++) {
+        difference.events[i] = current.events[i] - this->lastRead.events[i];
+    }
+    this->lastRead = current;
+    return difference;
+}
+
+void HardwareCounts::add(const HardwareCounts & other) {
+    for (size_t i = 0; i < HARDWARE_EVENT_AMOUNT; i++) {
+        this->events[i] += other.events[i];
+    }
+}
+
+double HardwareCounts::instructionsPerCycle() const {
+    if (this->events[CYCLES_EVENT] == 0) {
+        return 0;
+    }
+    return (double) this->events[INSTRUCTIONS_EVENT] / (double) this->events[CYCLES_EVENT];
+}
+
+std::string HardwareCounts::toJSON(int64_t fights) const {
+    std::stringstream s;
+    s << std::fixed << std::setprecision(3);
+    s << "{";
+        for (size_t i = 0; i < HARDWARE_EVENT_AMOUNT; i++) {
+            s << "\"" << HARDWARE_EVENT_NAMES[i] << "\"" << ":" << this->events[i] << ",";
+        }
+        s << "\"ipc\"" << ":" << this->instructionsPerCycle() << ",";
+        s << "\"cacheMissesPerFight\"" << ":" << (fights > 0 ? (double) this->events[CACHE_MISSES_EVENT] / (double) fights : 0) << ",";
+        s << "\"branchMissesPerFight\"" << ":" << (fights > 0 ? (double) this->events[BRANCH_MISSES_EVENT] / (double) fights : 0);
+    s << "}";
+    return s.str();
+}
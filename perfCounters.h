@@ -0,0 +1,46 @@
+#ifndef COSMOS_PERF_HEADER
+#define COSMOS_PERF_HEADER
+
+#include <string>
+#include <cstdint>
+
+const std::string PERF_COUNTERS_FLAG = "-perf-counters";
+
+enum HardwareEvent {
+    CYCLES_EVENT,
+    INSTRUCTIONS_EVENT,
+    CACHE_MISSES_EVENT,
+    BRANCH_MISSES_EVENT,
+    HARDWARE_EVENT_AMOUNT
+};
+const std::string HARDWARE_EVENT_NAMES[HARDWARE_EVENT_AMOUNT] {"cycles", "instructions", "cacheMisses", "branchMisses"};
+
+// Values of all hardware events over some stretch of execution
+struct HardwareCounts {
+    uint64_t events[HARDWARE_EVENT_AMOUNT] = {};
+
+    void add(const HardwareCounts & other);
+    double instructionsPerCycle() const;
+    std::string toJSON(int64_t fights) const;
+};
+
+// Hardware performance counters of the calling thread via Linux perf_event_open.
+// If the kernel or the machine does not provide them, available() is false and all reads return zeros.
+class PerfCounters {
+    private:
+        int fds[HARDWARE_EVENT_AMOUNT];
+        HardwareCounts lastRead;
+
+        HardwareCounts read();
+
+    public:
+        PerfCounters();
+        ~PerfCounters();
+        PerfCounters(const PerfCounters &) = delete;
+        PerfCounters & operator=(const PerfCounters &) = delete;
+
+        bool available() const;
+        HardwareCounts lap(); // Counts since the last call to lap, like lapNanoseconds
+};
+
+#endif
@@ -0,0 +1,865 @@
+#include "solver.h"
+
+#include <algorithm>
+#include <bitset>
+#include <ctime>
+#include <memory>
+
+#include "perfCounters.h"
+
+using namespace std;
+
+// Measures consecutive phases of the solver with the monotonic clock and optionally with hardware counters.
+// Finished phases are also passed on to the trace and progress stream of the context
+class PhaseClock {
+    private:
+        int64_t phaseStart;
+        unique_ptr<PerfCounters> perfCounters;
+        SolverMetrics & metrics;
+        SolverContext & context;
+        
+    public:
+        size_t armySize = 0; // Level the phases belong to
+        
+        PhaseClock(SolverMetrics & someMetrics, SolverContext & someContext) :
+            metrics(someMetrics),
+            context(someContext)
+        {
+            if (this->context.perfCounters) {
+                this->perfCounters.reset(new PerfCounters());
+                this->metrics.hardwareCountersUsed = this->perfCounters->available();
+            }
+            this->restart();
+        }
+        
+        // Ignore everything since the last phase ended
+        void restart() {
+            this->phaseStart = monotonicNanoseconds();
+            if (this->perfCounters) {
+                this->perfCounters->lap();
+            }
+        }
+        
+        // Finish a phase without hardware counts and return its time
+        int64_t lap(const string & name) {
+            int64_t start = this->phaseStart;
+            int64_t elapsed = lapNanoseconds(this->phaseStart);
+            if (this->perfCounters) {
+                this->perfCounters->lap();
+            }
+            if (this->context.trace) {
+                this->context.trace->span(name, "phase", start, this->phaseStart);
+            }
+            if (this->context.progress) {
+                this->context.progress->phaseFinished(this->armySize, name, elapsed);
+            }
+            return elapsed;
+        }
+        
+        // Finish a phase, add its hardware counts to the metrics and return its time
+        int64_t lap(SolverPhase phase) {
+            int64_t start = this->phaseStart;
+            int64_t elapsed = lapNanoseconds(this->phaseStart);
+            if (this->perfCounters) {
+                this->metrics.phaseHardware[phase].add(this->perfCounters->lap());
+            }
+            if (this->context.trace) {
+                this->context.trace->span(SOLVER_PHASE_NAMES[phase], "phase", start, this->phaseStart);
+            }
+            if (this->context.progress) {
+                this->context.progress->phaseFinished(this->armySize, SOLVER_PHASE_NAMES[phase], elapsed);
+            }
+            return elapsed;
+        }
+};
+
+// Pass a new best solution on to the trace and progress stream
+static void announceIncumbent(Instance & instance, SolverContext & context) {
+    if (instance.bestSolution.isEmpty()) {
+        return;
+    }
+    if (context.trace) {
+        context.trace->counter("incumbent", "{\"followers\":" + to_string(instance.bestSolution.followerCost) + "}");
+    }
+    if (context.progress) {
+        context.progress->newIncumbent(instance.bestSolution);
+    }
+}
+
+// Show the amount of armies that wait to be simulated on the frontier counter track of the trace
+static void traceFrontier(size_t pureArmies, size_t heroArmies, SolverContext & context) {
+    if (context.trace) {
+        context.trace->counter("frontier", "{\"pure\":" + to_string(pureArmies) + ",\"hero\":" + to_string(heroArmies) + "}");
+    }
+}
+
+// Fights left in the solve if the frontier keeps growing like it did from the last level to the current one.
+// Must be called after the metrics of the current level were started
+static double estimateRemainingFights(Instance & instance, size_t armySize) {
+    vector<LevelMetrics> & levels = instance.metrics.levels;
+    double pending = (double) (levels.back().pureArmies + levels.back().heroArmies);
+    double growth = 0;
+    if (levels.size() >= 2) {
+        LevelMetrics & previous = levels[levels.size() - 2];
+        growth = pending / max(1.0, (double) (previous.pureArmies + previous.heroArmies));
+    }
+    double estimate = 0;
+    for (size_t i = armySize; i <= instance.maxCombatants; i++) {
+        estimate += pending;
+        pending *= growth;
+    }
+    return estimate;
+}
+
+// Bytes reserved by a vector of armies
+static size_t armyBytes(const vector<Army> & armies) {
+    return armies.capacity() * sizeof(Army);
+}
+
+// Insert a winning army into the solutions of the instance, which keep the cheapest amount of them sorted by followers.
+// Once there are enough, only armies cheaper than the most expensive one can get in, so the upper bound is lowered to its cost
+static void keepSolution(Instance & instance, const Army & army, size_t amount) {
+    vector<Army> & solutions = instance.solutions;
+    for (size_t i = 0; i < solutions.size(); i++) {
+        if (solutions[i].monsterAmount == army.monsterAmount && equal(army.monsters, army.monsters + army.monsterAmount, solutions[i].monsters)) {
+            return; // The greedy solution can be found again later
+        }
+    }
+    solutions.insert(upper_bound(solutions.begin(), solutions.end(), army, hasFewerFollowers), army);
+    if (solutions.size() > amount) {
+        solutions.pop_back();
+    }
+    if (solutions.size() == amount) {
+        instance.followerUpperBound = solutions.back().followerCost;
+    }
+}
+
+// Requirements of the constraints that a unit fulfills
+static inline uint32_t requirementMask(MonsterIndex monster, const LineupConstraints & constraints) {
+    return (size_t) monster < constraints.requirementMasks.size() ? constraints.requirementMasks[monster] : 0;
+}
+
+// Requirements of the constraints that are already in the army
+static uint32_t coveredRequirements(const Army & army, const LineupConstraints & constraints) {
+    uint32_t covered = 0;
+    for (int i = 0; i < army.monsterAmount; i++) {
+        covered |= requirementMask(army.monsters[i], constraints);
+    }
+    return covered;
+}
+
+// Check if an army of armySize with these requirements covered can still fit the missing ones into its free slots
+static inline bool canCoverRequirements(uint32_t covered, size_t armySize, const Instance & instance, const LineupConstraints & constraints) {
+    uint32_t missing = ((1u << constraints.required.size()) - 1) & ~covered;
+    return bitset<32>(missing).count() + armySize <= instance.maxCombatants;
+}
+
+// Check if a winning army may be a solution under the constraints
+static bool meetsConstraints(const Army & army, const Instance & instance, const LineupConstraints & constraints) {
+    int heroes = 0;
+    for (int i = 0; i < army.monsterAmount; i++) {
+        heroes += monsterReference[army.monsters[i]].rarity != NO_HERO;
+    }
+    return (constraints.maxHeroes < 0 || heroes <= constraints.maxHeroes)
+        && canCoverRequirements(coveredRequirements(army, constraints), instance.maxCombatants, instance, constraints);
+}
+
+// Requirements covered by every army of a list, empty if nothing is required
+static vector<uint32_t> coveredRequirements(const vector<Army> & armies, const LineupConstraints & constraints) {
+    vector<uint32_t> covered;
+    if (!constraints.required.empty()) {
+        covered.reserve(armies.size());
+        for (size_t i = 0; i < armies.size(); i++) {
+            covered.push_back(coveredRequirements(armies[i], constraints));
+        }
+    }
+    return covered;
+}
+
+// Check if a is at least as good as b in followers and every pareto criterion
+static bool isParetoBetter(const Army & a, const Army & b, ParetoCriteria criteria) {
+    int aHeroes = 0, bHeroes = 0, aLevels = 0, bLevels = 0;
+    for (int i = 0; i < a.monsterAmount; i++) {
+        if (monsterReference[a.monsters[i]].rarity != NO_HERO) {
+            aHeroes++;
+            aLevels += monsterReference[a.monsters[i]].level;
+        }
+    }
+    for (int i = 0; i < b.monsterAmount; i++) {
+        if (monsterReference[b.monsters[i]].rarity != NO_HERO) {
+            bHeroes++;
+            bLevels += monsterReference[b.monsters[i]].level;
+        }
+    }
+    return a.followerCost <= b.followerCost && aHeroes <= bHeroes && (criteria != PARETO_HERO_LEVELS || aLevels <= bLevels);
+}
+
+// Put a winning army on the pareto front of the instance unless a lineup on it is at least as good. Lineups it beats leave the front.
+// A lineup without heroes beats everything that costs more, so it also lowers the upper bound
+static void keepParetoOptimal(Instance & instance, const Army & army, ParetoCriteria criteria) {
+    vector<Army> & front = instance.paretoFront;
+    for (size_t i = 0; i < front.size(); i++) {
+        if (isParetoBetter(front[i], army, criteria)) {
+            return;
+        }
+    }
+    front.erase(remove_if(front.begin(), front.end(), [&](const Army & other) {return isParetoBetter(army, other, criteria);}), front.end());
+    front.insert(upper_bound(front.begin(), front.end(), army, hasFewerFollowers), army);
+    
+    bool heroes = false;
+    for (int i = 0; i < army.monsterAmount; i++) {
+        heroes |= monsterReference[army.monsters[i]].rarity != NO_HERO;
+    }
+    if (!heroes && army.followerCost < instance.followerUpperBound) {
+        instance.followerUpperBound = army.followerCost;
+    }
+}
+
+// Drop every lineup of a pareto front that another one is at least as good as. Of equal lineups only the first stays
+void filterParetoFront(vector<Army> & front, ParetoCriteria criteria) {
+    vector<Army> kept;
+    for (size_t i = 0; i < front.size(); i++) {
+        bool dominated = false;
+        for (size_t j = 0; j < front.size() && !dominated; j++) {
+            dominated = j != i && isParetoBetter(front[j], front[i], criteria) && (j < i || !isParetoBetter(front[i], front[j], criteria));
+        }
+        if (!dominated) {
+            kept.push_back(front[i]);
+        }
+    }
+    front = move(kept);
+}
+
+// Check if a losing army got further against the target than the closest attempt so far
+static inline bool isCloserAttempt(const Army & army, const Army & closest) {
+    const FightResult & a = army.lastFightData;
+    const FightResult & b = closest.lastFightData;
+    if (closest.isEmpty() || a.monstersLost != b.monstersLost) {
+        return closest.isEmpty() || a.monstersLost > b.monstersLost;
+    }
+    return a.damage > b.damage || (a.damage == b.damage && army.followerCost < closest.followerCost);
+}
+
+// Simulates fights with all armies against the target. Armies will contain Army objects with the results written in.
+void simulateMultipleFights(vector<Army> & armies, Instance & instance, SolverContext & context) {
+    bool newFound = false;
+    bool constrained = !context.constraints.isEmpty();
+    size_t i = 0;
+    size_t armyAmount = armies.size();
+    
+    for (i = 0; i < armyAmount; i++) {
+        simulateFight(armies[i], instance.target);
+        if (!armies[i].lastFightData.rightWon) {  // left (our side) wins:
+            if ((armies[i].followerCost < instance.followerUpperBound || context.paretoCriteria != NO_PARETO) && (!constrained || meetsConstraints(armies[i], instance, context.constraints))) {
+                if (context.paretoCriteria != NO_PARETO) {
+                    keepParetoOptimal(instance, armies[i], context.paretoCriteria);
+                    if (!instance.bestSolution.isEmpty() && instance.bestSolution.followerCost <= armies[i].followerCost) {
+                        continue; // Only a point on the front
+                    }
+                } else if (context.solutionAmount > 1) {
+                    keepSolution(instance, armies[i], context.solutionAmount);
+                    if (!instance.bestSolution.isEmpty() && instance.bestSolution.followerCost <= armies[i].followerCost) {
+                        continue; // Only an alternative
+                    }
+                } else {
+                    instance.followerUpperBound = armies[i].followerCost;
+                }
+                if (!newFound) {
+                    context.io->suspendTimedOutputs(DETAILED_OUTPUT);
+                }
+                newFound = true;
+                instance.bestSolution = armies[i];
+                context.io->outputMessage(instance.bestSolution.toString(), DETAILED_OUTPUT, 2);
+                announceIncumbent(instance, context);
+                if (context.onNewSolution) {
+                    context.onNewSolution(instance);
+                }
+            }
+        } else if (instance.bestSolution.isEmpty() && isCloserAttempt(armies[i], instance.closestAttempt)) {
+            instance.closestAttempt = armies[i]; // Comes for free with the fights that are simulated anyway
+        }
+    }
+    if (newFound) {
+        context.io->resumeTimedOutputs(DETAILED_OUTPUT);
+    }
+}
+
+// Take the data from oldArmies and write all armies into newArmies with an additional monster at the end.
+// Armies that are dominated are ignored.
+void expand(vector<Army> & newPureArmies, vector<Army> & newHeroArmies, 
+            vector<Army> & oldPureArmies, vector<Army> & oldHeroArmies, 
+            size_t currentArmySize, Instance & instance, SolverContext & context, bool pureChildren) {
+
+    int remainingFollowers;
+    size_t availableMonstersSize = context.availableMonsters.size();
+    size_t availableHeroesSize = context.availableHeroes.size();
+    vector<bool> usedHeroes; usedHeroes.resize(availableHeroesSize, false);
+    size_t i, j, m;
+    SkillType currentSkill;
+    bool globalAbilityInfluence;
+    size_t childrenBefore;
+    
+    // Children that can't fit all required units anymore or use too many heroes are never built
+    const LineupConstraints & constraints = context.constraints;
+    bool requirements = !constraints.required.empty();
+    int heroLimit = constraints.maxHeroes < 0 ? ARMY_MAX_SIZE : constraints.maxHeroes;
+    int heroesUsed;
+    uint32_t covered = 0;
+    
+    for (i = 0; i < oldPureArmies.size(); i++) {
+        if (!oldPureArmies[i].lastFightData.dominated) {
+            childrenBefore = newPureArmies.size() + newHeroArmies.size();
+            remainingFollowers = instance.followerUpperBound - oldPureArmies[i].followerCost;
+            if (requirements) {
+                covered = coveredRequirements(oldPureArmies[i], constraints);
+            }
+            for (m = 0; pureChildren && m < availableMonstersSize && monsterReference[context.availableMonsters[m]].cost < remainingFollowers; m++) {
+                if (requirements && !canCoverRequirements(covered | requirementMask(context.availableMonsters[m], constraints), currentArmySize + 1, instance, constraints)) {
+                    continue;
+                }
+                newPureArmies.push_back(oldPureArmies[i]);
+                newPureArmies.back().add(context.availableMonsters[m]);
+                newPureArmies.back().lastFightData.valid = true;
+            }
+            for (m = 0; m < availableHeroesSize && heroLimit > 0; m++) {
+                if (requirements && !canCoverRequirements(covered | requirementMask(context.availableHeroes[m], constraints), currentArmySize + 1, instance, constraints)) {
+                    continue;
+                }
+                currentSkill = monsterReference[context.availableHeroes[m]].skill.type;
+                newHeroArmies.push_back(oldPureArmies[i]);
+                newHeroArmies.back().add(context.availableHeroes[m]);
+                newHeroArmies.back().lastFightData.valid = (currentSkill == P_AOE || currentSkill == FRIENDS || currentSkill == BERSERK || currentSkill == ADAPT); // These skills are self centered
+            }
+            countExpansion(newPureArmies.size() + newHeroArmies.size() - childrenBefore);
+        }
+    }
+    
+    for (i = 0; i < oldHeroArmies.size(); i++) {
+        if (!oldHeroArmies[i].lastFightData.dominated) {
+            childrenBefore = newHeroArmies.size();
+            globalAbilityInfluence = false;
+            heroesUsed = 0;
+            remainingFollowers = instance.followerUpperBound - oldHeroArmies[i].followerCost;
+            if (requirements) {
+                covered = coveredRequirements(oldHeroArmies[i], constraints);
+            }
+            for (j = 0; j < currentArmySize; j++) {
+                for (m = 0; m < availableHeroesSize; m++) {
+                    if (oldHeroArmies[i].monsters[j] == context.availableHeroes[m]) {
+                        currentSkill = monsterReference[oldHeroArmies[i].monsters[j]].skill.type;
+                        globalAbilityInfluence |= (currentSkill == FRIENDS || currentSkill == RAINBOW);
+                        usedHeroes[m] = true;
+                        heroesUsed++;
+                        break;
+                    }
+                }
+            }
+            for (m = 0; m < availableMonstersSize && monsterReference[context.availableMonsters[m]].cost < remainingFollowers; m++) {
+                if (requirements && !canCoverRequirements(covered | requirementMask(context.availableMonsters[m], constraints), currentArmySize + 1, instance, constraints)) {
+                    continue;
+                }
+                newHeroArmies.push_back(oldHeroArmies[i]);
+                newHeroArmies.back().add(context.availableMonsters[m]);
+                newHeroArmies.back().lastFightData.valid = !globalAbilityInfluence;
+            }
+            for (m = 0; m < availableHeroesSize; m++) {
+                if (!usedHeroes[m] && heroesUsed < heroLimit && (!requirements || canCoverRequirements(covered | requirementMask(context.availableHeroes[m], constraints), currentArmySize + 1, instance, constraints))) {
+                    currentSkill = monsterReference[context.availableHeroes[m]].skill.type;
+                    newHeroArmies.push_back(oldHeroArmies[i]);
+                    newHeroArmies.back().add(context.availableHeroes[m]);
+                    newHeroArmies.back().lastFightData.valid = (currentSkill == P_AOE || currentSkill == FRIENDS || currentSkill == BERSERK || currentSkill == ADAPT); // These skills are self centered
+                }
+                usedHeroes[m] = false;
+            }
+            countExpansion(newHeroArmies.size() - childrenBefore);
+        }
+    }
+}
+
+// Use a greedy method to get a first upper bound on follower cost for the solution
+// Greedy approach for 4 or less monsters is obsolete, as bruteforce is still fast enough
+void getQuickSolutions(Instance & instance, SolverContext & context) {
+    Army tempArmy = Army();
+    vector<MonsterIndex> greedy {};
+    vector<MonsterIndex> greedyHeroes {};
+    vector<MonsterIndex> greedyTemp {};
+    bool invalid = false;
+    
+    context.io->outputMessage("Trying to find solutions greedily...", DETAILED_OUTPUT);
+    
+    // Create Army that kills as many monsters as the army is big
+    if (instance.targetSize <= instance.maxCombatants) {
+        for (size_t i = 0; i < instance.maxCombatants; i++) {
+            for (size_t m = 0; m < context.availableMonsters.size(); m++) {
+                tempArmy = Army(greedy);
+                tempArmy.add(context.availableMonsters[m]);
+                simulateFight(tempArmy, instance.target);
+                if (!tempArmy.lastFightData.rightWon || (tempArmy.lastFightData.monstersLost > (int) i && i+1 < instance.maxCombatants)) { // the last monster has to win the encounter
+                    greedy.push_back(context.availableMonsters[m]);
+                    break;
+                }
+            }
+            invalid = greedy.size() < instance.maxCombatants;
+        }
+        if (!invalid) {
+            instance.bestSolution = tempArmy;
+            if (instance.followerUpperBound > tempArmy.followerCost) {
+                instance.followerUpperBound = tempArmy.followerCost;
+            }
+            
+            // Try to replace monsters in the setup with heroes to save followers
+            greedyHeroes = greedy;
+            for (size_t m = 0; m < context.availableHeroes.size(); m++) {
+                for (size_t i = 0; i < greedyHeroes.size(); i++) {
+                    greedyTemp = greedyHeroes;
+                    greedyTemp[i] = context.availableHeroes[m];
+                    tempArmy = Army(greedyTemp);
+                    simulateFight(tempArmy, instance.target);
+                    if (!tempArmy.lastFightData.rightWon) { // Setup still needs to win
+                        greedyHeroes = greedyTemp;
+                        break;
+                    }
+                }
+            }
+            tempArmy = Army(greedyHeroes);
+            instance.bestSolution = tempArmy;
+            if (instance.followerUpperBound > tempArmy.followerCost) { // Take care not to override custom follower counts
+                instance.followerUpperBound = tempArmy.followerCost;
+            }
+        }
+    }
+}
+
+// Check if a single monster or hero can beat the last two monsters of the target. If not, solutions that can only beat n-2 monsters need not be expanded later
+bool isOptimizable(vector<Army> & pureMonsterArmies, vector<Army> & heroMonsterArmies, Instance & instance) {
+    Army tempArmy;
+    size_t i;
+    
+    bool optimizable = (instance.targetSize > ARMY_MAX_BRUTEFORCEABLE_SIZE && instance.targetSize > 3);
+    if (optimizable) {
+        tempArmy = Army({instance.target.monsters[instance.targetSize - 2], instance.target.monsters[instance.targetSize - 1]}); // Make an army from the last two monsters
+    }
+
+    if (optimizable) { // Check with normal Mobs
+        for (i = 0; i < pureMonsterArmies.size(); i++) {
+            simulateFight(pureMonsterArmies[i], tempArmy);
+            if (!pureMonsterArmies[i].lastFightData.rightWon) { // Monster won the fight
+                optimizable = false;
+                break;
+            }
+        }
+    }
+
+    if (optimizable) { // Check with Heroes
+        for (i = 0; i < heroMonsterArmies.size(); i++) {
+            simulateFight(heroMonsterArmies[i], tempArmy);
+            if (!heroMonsterArmies[i].lastFightData.rightWon) { // Hero won the fight
+                optimizable = false;
+                break;
+            }
+        }
+    }
+    return optimizable;
+}
+
+// Mark pure armies that are dominated by cheaper pure armies and hero armies that are dominated by pure armies. Both lists must be sorted by followers
+void markDominatedPureArmies(vector<Army> & pureMonsterArmies, vector<Army> & heroMonsterArmies, size_t armySize, Instance & instance, const LineupConstraints & constraints, bool optimizable, size_t dominators, bool pureDominance) {
+    size_t pureMonsterArmiesSize = pureMonsterArmies.size();
+    size_t heroMonsterArmiesSize = heroMonsterArmies.size();
+    int leftFollowerCost;
+    FightResult * currentFightResult;
+    size_t i, j, beaten;
+    vector<size_t> heroBeaten(dominators > 1 ? heroMonsterArmiesSize : 0); // Pure armies that beat each hero army so far
+    // An army can only dominate armies that don't have required units it lacks
+    vector<uint32_t> pureCovered = coveredRequirements(pureMonsterArmies, constraints);
+    vector<uint32_t> heroCovered = coveredRequirements(heroMonsterArmies, constraints);
+    bool requirements = !pureCovered.empty();
+    
+    for (i = 0; i < pureMonsterArmiesSize; i++) {
+        leftFollowerCost = pureMonsterArmies[i].followerCost;
+        currentFightResult = &pureMonsterArmies[i].lastFightData;
+        // A result is obsolete if only one expansion is left but no single mob can beat the last two enemy mobs alone (optimizable)
+        if (armySize == (instance.maxCombatants - 1) && optimizable && pureDominance) {
+            // TODO: Investigate whether this is truly correct: What if the second-to-last mob is already damaged (not from aoe) i.e. it defeated the last mob of left?
+            if (currentFightResult->rightWon && currentFightResult->monstersLost < (int) (instance.targetSize - 2) && currentFightResult->rightAoeDamage == 0) {
+                currentFightResult->dominated = true;
+                COUNT(prunedOptimizable);
+            }
+        }
+        // A result is dominated If:
+        if (!currentFightResult->dominated) { 
+            // Another pureResults got farther with a less costly lineup
+            beaten = 0;
+            for (j = i+1; pureDominance && j < pureMonsterArmiesSize; j++) {
+                if (leftFollowerCost < pureMonsterArmies[j].followerCost) {
+                    break; 
+                } else if (*currentFightResult <= pureMonsterArmies[j].lastFightData && (!requirements || (pureCovered[i] & ~pureCovered[j]) == 0) && ++beaten >= dominators) { // currentFightResult has more followers implicitly 
+                    currentFightResult->dominated = true;
+                    COUNT(prunedPureDominance);
+                    break;
+                }
+            }
+            // A lineup without heroes is better than a setup with heroes even if it got just as far
+            for (j = 0; j < heroMonsterArmiesSize; j++) {
+                if (leftFollowerCost > heroMonsterArmies[j].followerCost) {
+                    break; 
+                } else if (heroMonsterArmies[j].lastFightData <= *currentFightResult && (!requirements || (heroCovered[j] & ~pureCovered[i]) == 0) && (dominators == 1 || ++heroBeaten[j] >= dominators)) { // currentFightResult has less followers implicitly
+                    #ifdef COSMOS_COUNTERS
+                    if (!heroMonsterArmies[j].lastFightData.dominated) {
+                        COUNT(prunedPureOverHero);
+                    }
+                    #endif
+                    heroMonsterArmies[j].lastFightData.dominated = true;
+                }                       
+            }
+        }
+    }
+}
+
+// Mark hero armies that are dominated by cheaper hero armies using a subset of their heroes. The list must be sorted by followers
+void markDominatedHeroArmies(vector<Army> & heroMonsterArmies, size_t armySize, Instance & instance, const LineupConstraints & constraints, bool optimizable, size_t dominators) {
+    size_t heroMonsterArmiesSize = heroMonsterArmies.size();
+    int leftFollowerCost;
+    FightResult * currentFightResult;
+    MonsterIndex leftHeroList[ARMY_MAX_SIZE];
+    size_t leftHeroListSize;
+    MonsterIndex rightMonster;
+    MonsterIndex leftMonster;
+    size_t i, j, sj, si, beaten;
+    vector<uint32_t> covered = coveredRequirements(heroMonsterArmies, constraints);
+    bool requirements = !covered.empty();
+    
+    bool usedHeroSubset, leftUsedHero;
+    for (i = 0; i < heroMonsterArmiesSize; i++) {
+        leftFollowerCost = heroMonsterArmies[i].followerCost;
+        currentFightResult = &heroMonsterArmies[i].lastFightData;
+        leftHeroListSize = 0;
+        for (si = 0; si < armySize; si++) {
+            leftMonster = heroMonsterArmies[i].monsters[si];
+            if (monsterReference[leftMonster].rarity != NO_HERO) {
+                leftHeroList[leftHeroListSize] = leftMonster;
+                leftHeroListSize++;
+            }
+        }
+
+        // A result is obsolete if only one expansion is left but no single mob can beat the last two enemy mobs alone (optimizable)
+        if (armySize == (instance.maxCombatants - 1) && optimizable && currentFightResult->rightAoeDamage == 0) {
+            // TODO: Investigate whether this is truly correct: What if the second-to-last mob is already damaged (not from aoe) i.e. it defeated the last mob of left?
+            if (currentFightResult->rightWon && currentFightResult->monstersLost < (int) (instance.targetSize - 2)){
+                COUNT_ADD(prunedOptimizable, !currentFightResult->dominated);
+                currentFightResult->dominated = true;
+            }
+        }
+
+        // A result is dominated If:
+        if (!currentFightResult->dominated) {
+            // if i costs more followers and got less far than j, then i is dominated
+            beaten = 0;
+            for (j = i+1; j < heroMonsterArmiesSize; j++) {
+                if (leftFollowerCost < heroMonsterArmies[j].followerCost) {
+                    break;
+                } else if (*currentFightResult <= heroMonsterArmies[j].lastFightData && (!requirements || (covered[i] & ~covered[j]) == 0)) { // i has more followers implicitly
+                    usedHeroSubset = true; // If j doesn't use a strict subset of the heroes i used, it cannot dominate i
+                    for (sj = 0; sj < armySize; sj++) { // for every hero in j there must be the same hero in i
+                        leftUsedHero = false; 
+                        rightMonster = heroMonsterArmies[j].monsters[sj];
+                        if (monsterReference[rightMonster].rarity != NO_HERO) {
+                            for (si = 0; si < leftHeroListSize; si++) {
+                                if (leftHeroList[si] == rightMonster) {
+                                    leftUsedHero = true;
+                                    break;
+                                }
+                            }
+                            if (!leftUsedHero) {
+                                usedHeroSubset = false;
+                                break;
+                            }
+                        }
+                    }
+                    if (usedHeroSubset && ++beaten >= dominators) {
+                        currentFightResult->dominated = true;
+                        COUNT(prunedHeroDominance);
+                        break;
+                    }                           
+                }
+            }
+        }
+    }
+}
+
+// Greedy lineups know neither the user's bound nor the constraints of the context. Missing required units are swapped in where the lineup still wins,
+// if that doesn't work out or the lineup costs more than the user's bound it is dropped and the search starts from that bound
+static void checkGreedySolution(Instance & instance, SolverContext & context, int userFollowerUpperBound) {
+    if (instance.bestSolution.isEmpty()) {
+        return;
+    }
+    if (instance.bestSolution.followerCost > userFollowerUpperBound) {
+        instance.bestSolution = Army();
+        return;
+    }
+    const LineupConstraints & constraints = context.constraints;
+    if (constraints.isEmpty() || meetsConstraints(instance.bestSolution, instance, constraints)) {
+        return;
+    }
+    vector<MonsterIndex> lineup(instance.bestSolution.monsters, instance.bestSolution.monsters + instance.bestSolution.monsterAmount);
+    vector<MonsterIndex> units = context.availableMonsters;
+    units.insert(units.end(), context.availableHeroes.begin(), context.availableHeroes.end());
+    for (size_t r = 0; r < constraints.required.size(); r++) {
+        if (coveredRequirements(Army(lineup), constraints) & (1u << r)) {
+            continue;
+        }
+        bool placed = false;
+        for (size_t u = 0; u < units.size() && !placed; u++) {
+            if (!(requirementMask(units[u], constraints) & (1u << r))) {
+                continue;
+            }
+            for (size_t slot = 0; slot < lineup.size() && !placed; slot++) {
+                if (requirementMask(lineup[slot], constraints) != 0) {
+                    continue; // Keep units that are required themselves
+                }
+                vector<MonsterIndex> candidate = lineup;
+                candidate[slot] = units[u];
+                Army tempArmy(candidate);
+                simulateFight(tempArmy, instance.target);
+                if (!tempArmy.lastFightData.rightWon) {
+                    lineup = candidate;
+                    placed = true;
+                }
+            }
+        }
+    }
+    Army repaired(lineup);
+    if (meetsConstraints(repaired, instance, constraints) && repaired.followerCost < userFollowerUpperBound) {
+        instance.bestSolution = repaired;
+        instance.followerUpperBound = repaired.followerCost;
+    } else {
+        instance.bestSolution = Army();
+        instance.followerUpperBound = userFollowerUpperBound;
+    }
+}
+
+// Units of a context list that the constraints allow at all
+static vector<MonsterIndex> allowedUnits(const vector<MonsterIndex> & units, const LineupConstraints & constraints) {
+    vector<MonsterIndex> allowed;
+    for (size_t i = 0; i < units.size(); i++) {
+        const Monster & unit = monsterReference[units[i]];
+        bool elementAllowed = constraints.elements.empty() || find(constraints.elements.begin(), constraints.elements.end(), unit.element) != constraints.elements.end();
+        bool forbidden = find(constraints.forbidden.begin(), constraints.forbidden.end(), unit.baseName) != constraints.forbidden.end();
+        if (elementAllowed && !forbidden && (unit.rarity == NO_HERO || constraints.maxHeroes != 0)) {
+            allowed.push_back(units[i]);
+        }
+    }
+    return allowed;
+}
+
+static void runSolver(Instance & instance, SolverContext & context);
+
+// Main method for solving an instance. Time taken to calculate is written into the instance
+void solveInstance(Instance & instance, SolverContext & context) {
+    if (context.constraints.isEmpty()) {
+        runSolver(instance, context);
+        return;
+    }
+    // Forbidden units are left out from the start, the rest of the constraints is checked while expanding
+    SolverContext constrainedContext = context;
+    constrainedContext.availableMonsters = allowedUnits(context.availableMonsters, context.constraints);
+    constrainedContext.availableHeroes = allowedUnits(context.availableHeroes, context.constraints);
+    
+    LineupConstraints & constraints = constrainedContext.constraints;
+    constraints.requirementMasks.clear();
+    for (size_t i = 0; i < constraints.required.size(); i++) {
+        for (int heroes = 0; heroes < 2; heroes++) {
+            const vector<MonsterIndex> & units = heroes ? constrainedContext.availableHeroes : constrainedContext.availableMonsters;
+            for (size_t m = 0; m < units.size(); m++) {
+                if (monsterReference[units[m]].baseName == constraints.required[i]) {
+                    if ((size_t) units[m] >= constraints.requirementMasks.size()) {
+                        constraints.requirementMasks.resize(units[m] + 1, 0);
+                    }
+                    constraints.requirementMasks[units[m]] |= 1u << i;
+                }
+            }
+        }
+    }
+    runSolver(instance, constrainedContext);
+}
+
+// Solve an instance with the units of the context
+static void runSolver(Instance & instance, SolverContext & context) {
+    size_t firstDominance = context.firstDominance;
+    time_t startTime;
+    int64_t solveStart = monotonicNanoseconds();
+    int fightsBefore;
+    
+    size_t i;
+    
+    totalFightsSimulated = &instance.totalFightsSimulated;
+    TraceScope instanceScope(context.trace, instance.target.toString(), "instance");
+    instance.metrics = SolverMetrics();
+    if (context.progress) {
+        context.progress->instanceStarted(instance);
+    }
+    PhaseClock clock(instance.metrics, context);
+    instance.counters = EngineCounters();
+    threadCounters = EngineCounters();
+
+    // Get first Upper limit on followers
+    instance.solutions.clear();
+    instance.paretoFront.clear();
+    instance.closestAttempt = Army();
+    int userFollowerUpperBound = instance.followerUpperBound;
+    if (instance.maxCombatants > ARMY_MAX_BRUTEFORCEABLE_SIZE && context.paretoCriteria != NO_PARETO) {
+        // Lineups with heroes may cost more than the greedy one as long as they use fewer heroes, so only a greedy lineup without them bounds the front
+        SolverContext pureContext = context;
+        pureContext.availableHeroes.clear();
+        getQuickSolutions(instance, pureContext);
+        checkGreedySolution(instance, pureContext, userFollowerUpperBound);
+        if (!instance.bestSolution.isEmpty()) {
+            keepParetoOptimal(instance, instance.bestSolution, context.paretoCriteria);
+        }
+        announceIncumbent(instance, context);
+    } else if (instance.maxCombatants > ARMY_MAX_BRUTEFORCEABLE_SIZE) {
+        getQuickSolutions(instance, context);
+        checkGreedySolution(instance, context, userFollowerUpperBound);
+        if (context.solutionAmount > 1) {
+            // Alternatives may cost more than the greedy solution, so it only counts as one of them
+            instance.followerUpperBound = userFollowerUpperBound;
+            if (!instance.bestSolution.isEmpty() && instance.bestSolution.followerCost < instance.followerUpperBound) {
+                keepSolution(instance, instance.bestSolution, context.solutionAmount);
+            }
+        }
+        announceIncumbent(instance, context);
+    }
+    
+    vector<Army> pureMonsterArmies {}; // initialize with all monsters
+    vector<Army> heroMonsterArmies {}; // initialize with all heroes
+    for (i = 0; i < context.availableMonsters.size(); i++) {
+        if (monsterReference[context.availableMonsters[i]].cost <= instance.followerUpperBound) {
+            pureMonsterArmies.push_back(Army( {context.availableMonsters[i]} ));
+        }
+    }
+    for (i = 0; i < context.availableHeroes.size(); i++) { // Ignore chacking for Hero Cost
+        heroMonsterArmies.push_back(Army( {context.availableHeroes[i]} ));
+    }
+    
+    // Check if a single monster can beat the last two monsters of the target. If not, solutions that can only beat n-2 monsters need not be expanded later
+    bool optimizable = isOptimizable(pureMonsterArmies, heroMonsterArmies, instance);
+    
+    instance.metrics.greedyNanoseconds = clock.lap("greedy");
+
+    // Run the Bruteforce Loop
+    startTime = time(NULL);
+    size_t pureMonsterArmiesSize, heroMonsterArmiesSize;
+    for (size_t armySize = 1; armySize <= instance.maxCombatants; armySize++) {
+    
+        pureMonsterArmiesSize = pureMonsterArmies.size();
+        heroMonsterArmiesSize = heroMonsterArmies.size();
+        instance.metrics.levels.push_back(LevelMetrics());
+        LevelMetrics & level = instance.metrics.levels.back();
+        level.armySize = armySize;
+        level.pureArmies = pureMonsterArmiesSize;
+        level.heroArmies = heroMonsterArmiesSize;
+        fightsBefore = instance.totalFightsSimulated;
+        TraceScope levelScope(context.trace, "armySize " + to_string(armySize), "level");
+        traceFrontier(pureMonsterArmiesSize, heroMonsterArmiesSize, context);
+        instance.metrics.recordMemory(level, armyBytes(pureMonsterArmies) + armyBytes(heroMonsterArmies));
+        clock.armySize = armySize;
+        if (context.progress) {
+            context.progress->levelStarted(armySize, pureMonsterArmiesSize, heroMonsterArmiesSize, instance.maxCombatants - armySize, estimateRemainingFights(instance, armySize));
+        }
+        // Output Debug Information
+        context.io->outputMessage("Starting loop for armies of size " + to_string(armySize), BASIC_OUTPUT);
+        if (context.onProgress && !context.onProgress(instance, armySize, pureMonsterArmiesSize, heroMonsterArmiesSize)) {
+            break; // Caller asked to stop, keep the best solution found so far
+        }
+        
+        // Run Fights for non-Hero setups
+        clock.restart();
+        context.io->timedOutput("Simulating " + to_string(pureMonsterArmiesSize) + " non-hero Fights... ", DETAILED_OUTPUT, 1, true);
+        simulateMultipleFights(pureMonsterArmies, instance, context);
+        level.phaseNanoseconds[SIMULATE_PURE_PHASE] = clock.lap(SIMULATE_PURE_PHASE);
+        
+        // Run fights for setups with heroes
+        context.io->timedOutput("Simulating " + to_string(heroMonsterArmiesSize) + " hero Fights... ", DETAILED_OUTPUT, 1);
+        simulateMultipleFights(heroMonsterArmies, instance, context);
+        level.phaseNanoseconds[SIMULATE_HERO_PHASE] = clock.lap(SIMULATE_HERO_PHASE);
+        level.fights = instance.totalFightsSimulated - fightsBefore;
+        levelScope.args = "{\"fights\":" + to_string(level.fights) + "}";
+        
+        // If we have a valid solution with 0 followers (or enough of them) there is no need to continue
+        bool collecting = context.solutionAmount > 1 || context.paretoCriteria != NO_PARETO;
+        if (instance.bestSolution.monsterAmount > 0 && instance.bestSolution.followerCost == 0 && (!collecting || instance.followerUpperBound == 0)) { break; }
+        
+        if (armySize < instance.maxCombatants) { 
+            // Sort the results by follower cost for some optimization
+            context.io->timedOutput("Sorting Lists... ", DETAILED_OUTPUT, 1);
+            sort(pureMonsterArmies.begin(), pureMonsterArmies.end(), hasFewerFollowers);
+            sort(heroMonsterArmies.begin(), heroMonsterArmies.end(), hasFewerFollowers);
+            level.phaseNanoseconds[SORT_PHASE] = clock.lap(SORT_PHASE);
+                
+            if (armySize == firstDominance && context.io->outputLevel == BASIC_OUTPUT) {
+                context.io->outputLevel = DETAILED_OUTPUT; // Switch output level after pure brutefore is exhausted
+            }
+            if (armySize == firstDominance) {
+                context.io->outputMessage("", DETAILED_OUTPUT);
+                if (!instance.bestSolution.isEmpty()) {
+                    context.io->outputMessage("Best Solution so far:", DETAILED_OUTPUT);
+                    context.io->outputMessage(instance.bestSolution.toString(), DETAILED_OUTPUT, 1);
+                } else {
+                    context.io->outputMessage("Could not find a solution yet!", DETAILED_OUTPUT);
+                }
+                if (!context.io->askYesNoQuestion("Continue calculation?", "  Continuing will most likely result in a cheaper solution but could consume a lot of RAM.\n", DETAILED_OUTPUT, POSITIVE_ANSWER)) {break;}
+                startTime = time(NULL);
+                clock.restart(); // Don't count the time spent waiting for an answer
+                context.io->outputMessage("\nPreparing to work on loop for armies of size " + to_string(armySize+1), BASIC_OUTPUT);
+                context.io->outputMessage("Currently considering " + to_string(pureMonsterArmies.size()) + " normal and " + to_string(heroMonsterArmies.size()) + " hero armies.", BASIC_OUTPUT);
+            }
+                
+            if (firstDominance <= armySize) {
+                // Calculate which results are strictly better than others (dominance). Collecting alternatives needs that many better armies
+                size_t dominators = context.paretoCriteria == NO_PARETO ? context.solutionAmount : 1;
+                context.io->timedOutput("Calculating Dominance for non-heroes... ", DETAILED_OUTPUT, 1, firstDominance == armySize);
+                markDominatedPureArmies(pureMonsterArmies, heroMonsterArmies, armySize, instance, context.constraints, optimizable, dominators);
+                level.phaseNanoseconds[DOMINANCE_PURE_PHASE] = clock.lap(DOMINANCE_PURE_PHASE);
+                
+                context.io->timedOutput("Calculating Dominance for heroes... ", DETAILED_OUTPUT, 1);
+                markDominatedHeroArmies(heroMonsterArmies, armySize, instance, context.constraints, optimizable, dominators);
+            }
+            level.phaseNanoseconds[DOMINANCE_HERO_PHASE] = clock.lap(DOMINANCE_HERO_PHASE);
+            for (i = 0; i < pureMonsterArmiesSize; i++) {
+                level.pureSurvivors += !pureMonsterArmies[i].lastFightData.dominated;
+            }
+            for (i = 0; i < heroMonsterArmiesSize; i++) {
+                level.heroSurvivors += !heroMonsterArmies[i].lastFightData.dominated;
+            }
+            
+            // now we expand to add the next monster to all non-dominated armies
+            clock.restart();
+            context.io->timedOutput("Expanding Lineups by one... ", DETAILED_OUTPUT, 1);
+            vector<Army> nextPureArmies;
+            vector<Army> nextHeroArmies;
+            expand(nextPureArmies, nextHeroArmies, pureMonsterArmies, heroMonsterArmies, armySize, instance, context);
+            level.nextPureArmies = nextPureArmies.size();
+            level.nextHeroArmies = nextHeroArmies.size();
+            level.phaseNanoseconds[EXPAND_PHASE] = clock.lap(EXPAND_PHASE);
+            traceFrontier(level.nextPureArmies, level.nextHeroArmies, context);
+            instance.metrics.recordMemory(level, armyBytes(pureMonsterArmies) + armyBytes(heroMonsterArmies) + armyBytes(nextPureArmies) + armyBytes(nextHeroArmies));
+
+            context.io->timedOutput("Moving Data... ", DETAILED_OUTPUT, 1);
+            pureMonsterArmies = move(nextPureArmies);
+            heroMonsterArmies = move(nextHeroArmies);
+            level.phaseNanoseconds[MOVE_PHASE] = clock.lap(MOVE_PHASE);
+        }
+        context.io->finishTimedOutput(DETAILED_OUTPUT);
+    }
+    if (context.paretoCriteria != NO_PARETO) {
+        filterParetoFront(instance.paretoFront, context.paretoCriteria); // Only what is left at the end is shown
+    }
+    instance.calculationTime = time(NULL) - startTime;
+    instance.metrics.totalNanoseconds = monotonicNanoseconds() - solveStart;
+    instance.metrics.monsterDataBytes = monsterDataBytes();
+    collectThreadCounters(instance.counters);
+    if (context.progress) {
+        context.progress->instanceFinished(instance);
+    }
+    instanceScope.args = "{\"fights\":" + to_string(instance.totalFightsSimulated) + ",\"followers\":" + to_string(instance.followerUpperBound) + "}";
+}
@@ -0,0 +1,79 @@
+#ifndef COSMOS_SOLVER_HEADER
+#define COSMOS_SOLVER_HEADER
+
+#include <vector>
+#include <functional>
+
+#include "cosmosClasses.h"
+#include "inputProcessing.h"
+#include "battleLogic.h"
+#include "cosmosTrace.h"
+#include "cosmosProgress.h"
+
+// What a pareto front of solutions minimizes besides followers
+enum ParetoCriteria {
+    NO_PARETO,          // Only look for the cheapest lineups
+    PARETO_HEROES,      // Amount of heroes used
+    PARETO_HERO_LEVELS  // Amount of heroes used and the sum of their levels
+};
+
+// Rules a solution has to follow besides beating the target. Units are monster names or hero names without levels
+struct LineupConstraints {
+    std::vector<std::string> required;  // Every one of these has to be in the lineup, at most ARMY_MAX_SIZE
+    std::vector<std::string> forbidden; // None of these may be in the lineup
+    int maxHeroes = -1;                 // -1 for no limit
+    std::vector<Element> elements;      // Units need one of these elements, empty for all
+    std::vector<uint32_t> requirementMasks; // Bit i is set for the units that are required[i], indexed by MonsterIndex. Filled by the solver
+    
+    bool isEmpty() const { return required.empty() && forbidden.empty() && maxHeroes < 0 && elements.empty(); }
+};
+
+// Everything a solve depends on besides the instance itself. Owned by whoever runs the solver
+struct SolverContext {
+    std::vector<MonsterIndex> availableMonsters;  // Indices of monsters that may be used, sorted by follower cost
+    std::vector<MonsterIndex> availableHeroes;    // Indices of the user's leveled heroes
+    size_t firstDominance = ARMY_MAX_BRUTEFORCEABLE_SIZE; // Army size at which dominance is first calculated
+    size_t solutionAmount = 1;              // Collect this many of the cheapest winning lineups in instance.solutions if more than 1
+    ParetoCriteria paretoCriteria = NO_PARETO; // Collect all pareto optimal lineups in instance.paretoFront instead, takes precedence over solutionAmount
+    LineupConstraints constraints;          // Rules every solution has to follow, none by default
+    IOManager * io;                         // Receives all messages of the solver
+    bool perfCounters = false;              // Read hardware counters per phase into the metrics of the instance
+    TraceWriter * trace = nullptr;          // Receives spans of instances, levels and phases if set
+    ProgressStream * progress = nullptr;    // Receives progress events as json lines if set
+
+    // Optional hooks. onProgress is called at the start of every army size and can stop the solve by returning false
+    std::function<bool(const Instance & instance, size_t armySize, size_t pureArmies, size_t heroArmies)> onProgress;
+    std::function<void(const Instance & instance)> onNewSolution;
+};
+
+// Simulates fights with all armies against the target. Armies will contain Army objects with the results written in.
+void simulateMultipleFights(std::vector<Army> & armies, Instance & instance, SolverContext & context);
+
+// Take the data from oldArmies and write all armies into newArmies with an additional monster at the end.
+// Armies that are dominated are ignored. Without pureChildren only the hero armies are expanded, for callers that keep their own pure armies
+void expand(std::vector<Army> & newPureArmies, std::vector<Army> & newHeroArmies,
+            std::vector<Army> & oldPureArmies, std::vector<Army> & oldHeroArmies,
+            size_t currentArmySize, Instance & instance, SolverContext & context, bool pureChildren = true);
+
+// Use a greedy method to get a first upper bound on follower cost for the solution
+void getQuickSolutions(Instance & instance, SolverContext & context);
+
+// Check if a single monster or hero of the armies of size 1 can beat the last two monsters of the target.
+// If not, solutions that can only beat n-2 monsters need not be expanded later
+bool isOptimizable(std::vector<Army> & pureMonsterArmies, std::vector<Army> & heroMonsterArmies, Instance & instance);
+
+// Mark pure armies that are dominated by cheaper pure armies and hero armies that are dominated by pure armies. Both lists must be sorted by followers.
+// An army is only dropped once as many armies as dominators beat it, so the cheapest that many solutions survive.
+// Without pureDominance only the hero armies are marked, e.g. when the pure armies were marked before and are shared
+void markDominatedPureArmies(std::vector<Army> & pureMonsterArmies, std::vector<Army> & heroMonsterArmies, size_t armySize, Instance & instance, const LineupConstraints & constraints, bool optimizable, size_t dominators = 1, bool pureDominance = true);
+
+// Mark hero armies that are dominated by cheaper hero armies using a subset of their heroes. The list must be sorted by followers
+void markDominatedHeroArmies(std::vector<Army> & heroMonsterArmies, size_t armySize, Instance & instance, const LineupConstraints & constraints, bool optimizable, size_t dominators = 1);
+
+// Drop every lineup of a pareto front that another one is at least as good as in followers and the criteria
+void filterParetoFront(std::vector<Army> & front, ParetoCriteria criteria);
+
+// Main method for solving an instance. Time taken to calculate is written into the instance
+void solveInstance(Instance & instance, SolverContext & context);
+
+#endif
@@ -0,0 +1,483 @@
+#include "solverServer.h"
+#include "inputProcessing.h"
+
+#include <iostream>
+#include <sstream>
+#include <list>
+#include <vector>
+#include <chrono>
+#include <stdexcept>
+#include <cstring>
+#include <cstdlib>
+
+using namespace std;
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+const int LISTEN_BACKLOG = 16;
+const size_t READ_CHUNK_SIZE = 4096;
+
+// A solve request as it moves from the queue to a worker
+struct ServerRequest {
+    string id;
+    int priority;
+    long long deadline;     // Milliseconds on the steady clock, -1 for no deadline
+    unsigned long sequence; // Arrival order, used to break ties in priority
+    int client;             // Socket of the requesting connection
+    string body;            // Macro lines that are fed into the worker's input
+
+    pid_t worker = -1;
+    int outputPipe = -1;
+    string output;
+};
+
+// A connected client and the request it is currently sending
+struct ServerClient {
+    int socket;
+    string buffer;
+    bool readingBody = false;
+    ServerRequest pending;
+};
+
+static long long currentMillis() {
+    return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Write a full reply line to a client. Errors are ignored, a broken connection is noticed by the next read
+static void sendLine(int socket, const string & line) {
+    string data = line + "\n";
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t result = send(socket, data.c_str() + written, data.size() - written, MSG_NOSIGNAL);
+        if (result <= 0) {
+            return;
+        }
+        written += (size_t) result;
+    }
+}
+
+static void sendStatus(int socket, const string & id, const string & status, const string & extra = "") {
+    sendLine(socket, "{\"id\":\"" + escapeJSON(id) + "\",\"status\":\"" + status + "\"" + extra + "}");
+}
+
+// Open the listening socket. Numeric addresses are localhost tcp ports, everything else is a unix socket path
+static int openListenSocket(const string & address) {
+    int listenSocket;
+    bool isPort = !address.empty() && address.find_first_not_of("0123456789") == string::npos;
+
+    if (isPort) {
+        sockaddr_in inetAddress;
+        int reuse = 1;
+        memset(&inetAddress, 0, sizeof(inetAddress));
+        inetAddress.sin_family = AF_INET;
+        inetAddress.sin_port = htons((uint16_t) stoi(address));
+        inetAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+        setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (listenSocket < 0 || ::bind(listenSocket, (sockaddr *) &inetAddress, sizeof(inetAddress)) < 0) {
+            throw runtime_error("Could not bind to port " + address);
+        }
+    } else {
+        sockaddr_un unixAddress;
+        if (address.size() >= sizeof(unixAddress.sun_path)) {
+            throw runtime_error("Socket path too long");
+        }
+        memset(&unixAddress, 0, sizeof(unixAddress));
+        unixAddress.sun_family = AF_UNIX;
+        strcpy(unixAddress.sun_path, address.c_str());
+        unlink(address.c_str());
+        listenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenSocket < 0 || ::bind(listenSocket, (sockaddr *) &unixAddress, sizeof(unixAddress)) < 0) {
+            throw runtime_error("Could not bind to " + address);
+        }
+    }
+    if (listen(listenSocket, LISTEN_BACKLOG) < 0) {
+        throw runtime_error("Could not listen on " + address);
+    }
+    return listenSocket;
+}
+
+class Server {
+    private:
+        ServerConfig config;
+        function<void(const string &)> session;
+
+        int listenSocket;
+        list<ServerClient> clients;
+        list<ServerRequest> queued;
+        list<ServerRequest> running;
+        unsigned long nextSequence = 0;
+
+        bool isKnownId(const string & id);
+        void handleLine(ServerClient & client, const string & line);
+        void enqueue(ServerRequest request);
+        int cancel(const string & id, const string & status);
+        void stopWorker(ServerRequest & request);
+        void startWorker(ServerRequest & request);
+        void finishWorker(list<ServerRequest>::iterator request);
+        void dispatch();
+        void checkDeadlines();
+        void disconnect(list<ServerClient>::iterator client);
+        int pollTimeout();
+
+    public:
+        Server(const ServerConfig & config, function<void(const string &)> session);
+        void run();
+};
+
+Server::Server(const ServerConfig & someConfig, function<void(const string &)> aSession) :
+    config(someConfig),
+    session(aSession)
+{
+    this->listenSocket = openListenSocket(this->config.address);
+}
+
+bool Server::isKnownId(const string & id) {
+    for (auto it = this->queued.begin(); it != this->queued.end(); it++) {
+        if (it->id == id) { return true; }
+    }
+    for (auto it = this->running.begin(); it != this->running.end(); it++) {
+        if (it->id == id) { return true; }
+    }
+    return false;
+}
+
+// Process a single line of client input. Outside of a request body every line is a command
+void Server::handleLine(ServerClient & client, const string & line) {
+    if (client.readingBody) {
+        if (line == REQUEST_END) {
+            client.readingBody = false;
+            this->enqueue(client.pending);
+        } else {
+            client.pending.body += line + "\n";
+        }
+        return;
+    }
+
+    istringstream tokens(line);
+    string command, id, option;
+    tokens >> command >> id;
+    if (command == SOLVE_COMMAND && !id.empty()) {
+        client.pending = ServerRequest();
+        client.pending.id = id;
+        client.pending.priority = 0;
+        client.pending.deadline = -1;
+        client.pending.client = client.socket;
+        while (tokens >> option) {
+            try {
+                if (option.compare(0, PRIORITY_OPTION.size(), PRIORITY_OPTION) == 0) {
+                    client.pending.priority = stoi(option.substr(PRIORITY_OPTION.size()));
+                } else if (option.compare(0, DEADLINE_OPTION.size(), DEADLINE_OPTION) == 0) {
+                    client.pending.deadline = currentMillis() + stoll(option.substr(DEADLINE_OPTION.size()));
+                }
+            } catch (const exception & e) {}
+        }
+        client.readingBody = true;
+    } else if (command == CANCEL_COMMAND && !id.empty()) {
+        if (this->isKnownId(id)) {
+            if (this->cancel(id, "cancelled") != client.socket) {
+                sendStatus(client.socket, id, "cancelled"); // Acknowledge cancellations of other connections' requests
+            }
+        } else {
+            sendStatus(client.socket, id, "unknown");
+        }
+    } else if (!line.empty()) {
+        sendStatus(client.socket, id, "invalid", ",\"reason\":\"Unknown command\"");
+    }
+}
+
+// Add a fully received request to the queue if there is room
+void Server::enqueue(ServerRequest request) {
+    if (this->isKnownId(request.id)) {
+        sendStatus(request.client, request.id, "rejected", ",\"reason\":\"Duplicate id\"");
+    } else if (this->queued.size() >= this->config.maxQueue) {
+        sendStatus(request.client, request.id, "rejected", ",\"reason\":\"Queue full\"");
+    } else {
+        request.sequence = this->nextSequence++;
+        this->queued.push_back(request);
+        sendStatus(request.client, request.id, "queued", ",\"position\":" + to_string(this->queued.size()));
+    }
+}
+
+// Remove a request from the queue or stop its worker. The requesting client is told why and returned
+int Server::cancel(const string & id, const string & status) {
+    int client = -1;
+    for (auto it = this->queued.begin(); it != this->queued.end(); it++) {
+        if (it->id == id) {
+            client = it->client;
+            sendStatus(it->client, it->id, status);
+            this->queued.erase(it);
+            return client;
+        }
+    }
+    for (auto it = this->running.begin(); it != this->running.end(); it++) {
+        if (it->id == id) {
+            client = it->client;
+            this->stopWorker(*it);
+            sendStatus(it->client, it->id, status);
+            this->running.erase(it);
+            return client;
+        }
+    }
+    return client;
+}
+
+void Server::stopWorker(ServerRequest & request) {
+    kill(request.worker, SIGKILL);
+    waitpid(request.worker, NULL, 0);
+    close(request.outputPipe);
+}
+
+// Fork a worker process that runs the session on the request body and writes its output into a pipe
+void Server::startWorker(ServerRequest & request) {
+    int pipeEnds[2];
+    if (pipe(pipeEnds) < 0) {
+        throw runtime_error("Could not create pipe for worker");
+    }
+    cout.flush();
+    request.worker = fork();
+    if (request.worker < 0) {
+        throw runtime_error("Could not fork worker");
+    }
+
+    if (request.worker == 0) {
+        // Worker: Only keep the pipe as output and no interactive input
+        close(this->listenSocket);
+        for (auto it = this->clients.begin(); it != this->clients.end(); it++) {
+            close(it->socket);
+        }
+        for (auto it = this->running.begin(); it != this->running.end(); it++) {
+            close(it->outputPipe);
+        }
+        close(pipeEnds[0]);
+        dup2(pipeEnds[1], STDOUT_FILENO);
+        close(pipeEnds[1]);
+        int nullInput = open("/dev/null", O_RDONLY);
+        dup2(nullInput, STDIN_FILENO);
+        close(nullInput);
+
+        int exitCode = EXIT_SUCCESS;
+        try {
+            this->session(request.body);
+        } catch (const exception & e) {
+            cout << e.what() << endl; // Becomes the reason of the failure
+            exitCode = EXIT_FAILURE;
+        }
+        cout.flush();
+        _exit(exitCode);
+    }
+    close(pipeEnds[1]);
+    request.outputPipe = pipeEnds[0];
+    sendStatus(request.client, request.id, "running");
+}
+
+// Collect the exit status of a worker whose output is complete and send the results to the client
+void Server::finishWorker(list<ServerRequest>::iterator request) {
+    int status;
+    vector<string> lines;
+    string line;
+
+    waitpid(request->worker, &status, 0);
+    close(request->outputPipe);
+
+    // Results are json objects, everything else the session prints is a message about what went wrong
+    istringstream output(request->output);
+    string results;
+    string messages;
+    while (getline(output, line)) {
+        if (line.size() >= 2 && line.front() == '{' && line.back() == '}') {
+            results += (results.empty() ? "" : ",") + line;
+        } else if (!line.empty() && messages.find(line) == string::npos) { // Repeated for every rejected input line
+            messages += (messages.empty() ? "" : " ") + line;
+        }
+    }
+    if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS && !results.empty() && messages.empty()) {
+        sendStatus(request->client, request->id, "done", ",\"results\":[" + results + "]");
+    } else {
+        sendStatus(request->client, request->id, "failed", ",\"reason\":\"" + escapeJSON(messages.empty() ? "Incomplete or invalid request" : messages) + "\"");
+    }
+    this->running.erase(request);
+}
+
+// Start the most urgent requests while there are free workers
+void Server::dispatch() {
+    list<ServerRequest>::iterator best;
+    size_t freeWorkers;
+    while (!this->queued.empty() && this->running.size() < this->config.workers) {
+        best = this->queued.begin();
+        for (auto it = this->queued.begin(); it != this->queued.end(); it++) {
+            if (it->priority > best->priority || (it->priority == best->priority && it->sequence < best->sequence)) {
+                best = it;
+            }
+        }
+        freeWorkers = this->config.workers - this->running.size();
+        if (best->priority <= 0 && freeWorkers <= this->config.reservedWorkers) {
+            return; // Remaining workers are kept free for urgent requests
+        }
+        this->running.splice(this->running.end(), this->queued, best);
+        this->startWorker(this->running.back());
+    }
+}
+
+// Drop all queued and running requests that are past their deadline
+void Server::checkDeadlines() {
+    long long now = currentMillis();
+    vector<string> expired;
+    for (auto it = this->queued.begin(); it != this->queued.end(); it++) {
+        if (it->deadline >= 0 && it->deadline <= now) { expired.push_back(it->id); }
+    }
+    for (auto it = this->running.begin(); it != this->running.end(); it++) {
+        if (it->deadline >= 0 && it->deadline <= now) { expired.push_back(it->id); }
+    }
+    for (size_t i = 0; i < expired.size(); i++) {
+        this->cancel(expired[i], "expired");
+    }
+}
+
+// Close a connection and drop everything it requested
+void Server::disconnect(list<ServerClient>::iterator client) {
+    vector<string> orphaned;
+    for (auto it = this->queued.begin(); it != this->queued.end(); it++) {
+        if (it->client == client->socket) { orphaned.push_back(it->id); }
+    }
+    for (auto it = this->running.begin(); it != this->running.end(); it++) {
+        if (it->client == client->socket) { orphaned.push_back(it->id); }
+    }
+    for (size_t i = 0; i < orphaned.size(); i++) {
+        this->cancel(orphaned[i], "cancelled");
+    }
+    close(client->socket);
+    this->clients.erase(client);
+}
+
+// Time until the next deadline runs out, -1 if there is none
+int Server::pollTimeout() {
+    long long next = -1;
+    for (auto it = this->queued.begin(); it != this->queued.end(); it++) {
+        if (it->deadline >= 0 && (next < 0 || it->deadline < next)) { next = it->deadline; }
+    }
+    for (auto it = this->running.begin(); it != this->running.end(); it++) {
+        if (it->deadline >= 0 && (next < 0 || it->deadline < next)) { next = it->deadline; }
+    }
+    if (next < 0) {
+        return -1;
+    }
+    return (int) max(0LL, next - currentMillis());
+}
+
+void Server::run() {
+    vector<pollfd> fds;
+    char chunk[READ_CHUNK_SIZE];
+    ssize_t received;
+    size_t lineEnd, i;
+
+    while (true) {
+        fds.clear();
+        fds.push_back({this->listenSocket, POLLIN, 0});
+        for (auto it = this->running.begin(); it != this->running.end(); it++) {
+            fds.push_back({it->outputPipe, POLLIN, 0});
+        }
+        for (auto it = this->clients.begin(); it != this->clients.end(); it++) {
+            fds.push_back({it->socket, POLLIN, 0});
+        }
+        if (poll(fds.data(), fds.size(), this->pollTimeout()) < 0) {
+            continue; // Interrupted by a signal
+        }
+
+        // Order matters: fds were added as listen socket, workers, clients. Workers are handled first as client commands can cancel them
+        i = 1;
+        for (auto it = this->running.begin(); it != this->running.end(); i++) {
+            auto current = it++;
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            received = read(current->outputPipe, chunk, sizeof(chunk));
+            if (received > 0) {
+                current->output.append(chunk, (size_t) received);
+            } else {
+                this->finishWorker(current);
+            }
+        }
+        for (auto it = this->clients.begin(); it != this->clients.end(); i++) {
+            auto current = it++;
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            received = recv(current->socket, chunk, sizeof(chunk), 0);
+            if (received <= 0) {
+                this->disconnect(current);
+                continue;
+            }
+            current->buffer.append(chunk, (size_t) received);
+            while ((lineEnd = current->buffer.find('\n')) != string::npos) {
+                string line = current->buffer.substr(0, lineEnd);
+                current->buffer.erase(0, lineEnd + 1);
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+                this->handleLine(*current, line);
+            }
+        }
+        if (fds[0].revents & POLLIN) {
+            int clientSocket = accept(this->listenSocket, NULL, NULL);
+            if (clientSocket >= 0) {
+                this->clients.push_back(ServerClient());
+                this->clients.back().socket = clientSocket;
+            }
+        }
+
+        this->checkDeadlines();
+        this->dispatch();
+    }
+}
+
+// Accept solve requests until the process is terminated
+int runServer(const ServerConfig & config, function<void(const string &)> session) {
+    try {
+        Server server(config, session);
+        cout << "Listening on " << config.address << " with " << config.workers << " workers." << endl;
+        server.run();
+    } catch (const exception & e) {
+        cout << e.what() << endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+#else
+// Sockets and worker processes are only implemented for posix systems
+int runServer(const ServerConfig & config, function<void(const string &)> session) {
+    cout << "Server mode is not available on Windows." << endl;
+    return EXIT_FAILURE;
+}
+#endif
+
+// Parse server options from the command line starting at argument index first
+ServerConfig parseServerConfig(int argc, char** argv, int first) {
+    ServerConfig config;
+    string flag;
+    for (int i = first; i + 1 < argc; i++) { // Session flags may be mixed in, so only these flags take the next argument
+        flag = argv[i];
+        if (flag == LISTEN_FLAG) {
+            config.address = argv[++i];
+        } else if (flag == WORKERS_FLAG) {
+            config.workers = (size_t) max(1, stoi(argv[++i]));
+        } else if (flag == QUEUE_FLAG) {
+            config.maxQueue = (size_t) max(1, stoi(argv[++i]));
+        } else if (flag == RESERVE_FLAG) {
+            config.reservedWorkers = (size_t) max(0, stoi(argv[++i]));
+        }
+    }
+    if (config.reservedWorkers >= config.workers) {
+        config.reservedWorkers = config.workers - 1;
+    }
+    return config;
+}
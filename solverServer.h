@@ -0,0 +1,34 @@
+#ifndef COSMOS_SERVER_HEADER
+#define COSMOS_SERVER_HEADER
+
+#include <string>
+#include <functional>
+
+const std::string LISTEN_FLAG = "-listen";
+const std::string WORKERS_FLAG = "-workers";
+const std::string QUEUE_FLAG = "-queue";
+const std::string RESERVE_FLAG = "-reserve";
+
+// Commands understood by the server. Every command is a single line, solve is followed by a macro body terminated by REQUEST_END
+const std::string SOLVE_COMMAND = "solve";
+const std::string CANCEL_COMMAND = "cancel";
+const std::string REQUEST_END = "end";
+const std::string PRIORITY_OPTION = "priority=";
+const std::string DEADLINE_OPTION = "deadline=";
+
+// Settings for the server mode
+struct ServerConfig {
+    std::string address;        // Path of a unix domain socket or a port number for a localhost tcp socket
+    size_t workers = 2;         // Amount of solves that run at the same time
+    size_t maxQueue = 64;       // Requests waiting for a worker. Further requests are rejected
+    size_t reservedWorkers = 0; // Workers that only take requests with a priority above 0, keeps latency low for small quests
+};
+
+// Parse server options from the command line starting at argument index first
+ServerConfig parseServerConfig(int argc, char** argv, int first);
+
+// Accept solve requests until the process is terminated. Every request runs in its own worker process
+// which calls session with the request body and sends everything the session prints back to the client.
+int runServer(const ServerConfig & config, std::function<void(const std::string &)> session);
+
+#endif